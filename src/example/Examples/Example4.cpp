@@ -58,13 +58,15 @@ void Example::create(const Options& options) {
     auto *axisZ = new Axes::Axis(days, dayCount);
     auto *axisW = new Axes::Axis(skills, skillCount);
 
+    // Each NRP shift admits a single skill, so only assignable skills are stored
     Domain::State::DomainState state(
         range,
         timeZone,
         axisX,
         axisY,
         axisZ,
-        axisW
+        axisW,
+        Domain::Constraints::RequiredSkillConstraint::assignableConcepts(*axisX, *axisY, *axisW)
     );
 
     // for (int i = 0; i < shiftCount; i++) { state.set(i, 0, 0, 0); }
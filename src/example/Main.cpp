@@ -75,6 +75,7 @@ void solve(const std::filesystem::path& outputDirectory, const Search::LocalSear
             localSearch.configureDlas({.historyLength = 48, .maxIdleIterationCount = 500000});
             localSearch.configureTabuMove({.tabuTenure = 64, .maxIdleIterationCount = 500000});
             localSearch.configureTabuState({.tabuTenure = 256, .maxIdleIterationCount = 500000});
+            localSearch.configureBestImprovement({.maxIdleIterationCount = 20000});
             localSearch.configureSa({
                 .initialTemperature = 15000.0, .minTemperature = 1e-8, .coolingRate = 0.999,
                 .stepsPerTemperature = 400, .reheatIdleThreshold = 4000, .reheatFactor = 2.0,
@@ -90,6 +91,7 @@ void solve(const std::filesystem::path& outputDirectory, const Search::LocalSear
             localSearch.configureDlas({.historyLength = 96, .maxIdleIterationCount = 1200000});
             localSearch.configureTabuMove({.tabuTenure = 128, .maxIdleIterationCount = 1200000});
             localSearch.configureTabuState({.tabuTenure = 512, .maxIdleIterationCount = 1200000});
+            localSearch.configureBestImprovement({.maxIdleIterationCount = 40000});
             localSearch.configureSa({
                 .initialTemperature = 30000.0, .minTemperature = 1e-8, .coolingRate = 0.9992,
                 .stepsPerTemperature = 600, .reheatIdleThreshold = 6000, .reheatFactor = 2.5,
@@ -105,6 +107,7 @@ void solve(const std::filesystem::path& outputDirectory, const Search::LocalSear
             localSearch.configureDlas({.historyLength = 160, .maxIdleIterationCount = 2000000});
             localSearch.configureTabuMove({.tabuTenure = 256, .maxIdleIterationCount = 2000000});
             localSearch.configureTabuState({.tabuTenure = 1024, .maxIdleIterationCount = 2000000});
+            localSearch.configureBestImprovement({.maxIdleIterationCount = 80000});
             localSearch.configureSa({
                 .initialTemperature = 60000.0, .minTemperature = 1e-8, .coolingRate = 0.9995,
                 .stepsPerTemperature = 800, .reheatIdleThreshold = 10000, .reheatFactor = 3.0,
@@ -235,6 +238,8 @@ int main(int argc, char** argv) {
         {"TABU", Search::LocalSearchType::TABU_MOVE},
         {"TABU_MOVE", Search::LocalSearchType::TABU_MOVE},
         {"TABU_STATE", Search::LocalSearchType::TABU_STATE},
+        {"BEST", Search::LocalSearchType::BEST_IMPROVEMENT},
+        {"BEST_IMPROVEMENT", Search::LocalSearchType::BEST_IMPROVEMENT},
     };
 
     constexpr std::string_view algoPrefix = "--algorithm=";
@@ -1,11 +1,21 @@
 #ifndef BITARRAY_H
 #define BITARRAY_H
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <new>
 #include <string>
 #include <iostream>
+#include <iterator>
 #include <vector>
 #include <random>
+#include <utility>
+
+#include "Utils/SimdUtils.h"
 
 #ifdef _WIN32
 #pragma intrinsic(__popcnt64) // Required for MSVC
@@ -92,12 +102,6 @@ namespace BitArray {
     protected:
         array_size_t m_Size;
 
-    private:
-        friend class BitArray;
-        friend class BitMatrix::BitSymmetricalMatrix;
-        friend class BitMatrix::BitSquareMatrix;
-        friend class BitMatrix::BitMatrix;
-        friend class BitMatrix::BitMatrix3D;
     };
 
     template<std::integral T>
@@ -119,8 +123,10 @@ namespace BitArray {
         // return count;
     }
 
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
     struct Word {
-        typedef uint32_t word_t;
+        typedef uint64_t word_t;
 
         word_t bits;
 
@@ -153,205 +159,301 @@ namespace BitArray {
         static constexpr array_size_t length = sizeof(word_t) * 8;
         static constexpr uint8_t BYTE_SIZE = sizeof(word_t);
         static constexpr word_t ALL_BITS_SET = static_cast<word_t>(-1);
+        static constexpr array_size_t WORDS_PER_CACHE_LINE = CACHE_LINE_SIZE / BYTE_SIZE;
 
         [[nodiscard]] constexpr uint8_t countBits() const noexcept {
             return ::BitArray::countBits(bits);
         }
     };
 
-    class BitArray final : public BitArrayInterface {
+    /**
+     * Forward range over the indices of the set bits in [start; end) of a word array; each step costs one
+     * `countr_zero`, and clear words are skipped whole.
+     */
+    class SetBits {
     public:
-        explicit BitArray(const array_size_t size) noexcept : BitArrayInterface(size),
-                                                     m_WordCount((size + Word::length - 1) / Word::length),
-                                                     m_Words(nullptr) {
-            if (m_WordCount > 0) [[likely]] { m_Words = new Word[m_WordCount](); }
-        }
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = array_size_t;
+            using difference_type = std::ptrdiff_t;
 
-        BitArray(const BitArray& other) noexcept : BitArrayInterface(other.m_Size),
-                                          m_WordCount(other.m_WordCount),
-                                          m_Words(nullptr) {
-            if (other.m_WordCount > 0) [[likely]] {
-                m_Words = new Word[m_WordCount];
-                for (array_size_t i = 0; i < m_WordCount; ++i) {
-                    // ReSharper disable once CppDFANullDereference
-                    m_Words[i] = other.m_Words[i];
-                }
+            Iterator() noexcept = default;
+
+            [[nodiscard]] array_size_t operator*() const noexcept {
+                return m_Word * Word::length + static_cast<array_size_t>(std::countr_zero(m_Bits));
             }
-        }
 
-        BitArray& operator=(const BitArray& rhs) noexcept {
-            if (this == &rhs) [[unlikely]] return *this;
-            delete[] m_Words;
-            m_Size = rhs.m_Size;
-            m_WordCount = rhs.m_WordCount;
-            if (m_WordCount > 0) [[likely]] {
-                m_Words = new Word[m_WordCount];
-                for (array_size_t i = 0; i < m_WordCount; ++i) {
-                    // ReSharper disable once CppDFANullDereference
-                    m_Words[i] = rhs.m_Words[i];
+            Iterator& operator++() noexcept {
+                m_Bits &= m_Bits - 1;
+                if (m_Bits == 0) advance();
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
+                return m_Word == other.m_Word && m_Bits == other.m_Bits;
+            }
+
+        private:
+            friend class SetBits;
+
+            const Word *mp_Words = nullptr;
+            array_size_t m_Word = 0;
+            array_size_t m_EndWord = 0; // One past the last word of the range; the iterator ends there.
+            Word::word_t m_TailMask = 0;
+            Word::word_t m_Bits = 0;
+
+            Iterator(const Word *words, const array_size_t start, const array_size_t end) noexcept : mp_Words(words) {
+                if (start >= end) return;
+                m_EndWord = (end + Word::length - 1) / Word::length;
+                m_TailMask = Word::ALL_BITS_SET >> (m_EndWord * Word::length - end);
+                m_Word = start / Word::length;
+                m_Bits = mp_Words[m_Word].bits & Word::ALL_BITS_SET << start % Word::length;
+                if (m_Word + 1 == m_EndWord) m_Bits &= m_TailMask;
+                if (m_Bits == 0) advance();
+            }
+
+            void advance() noexcept {
+                while (++m_Word < m_EndWord) {
+                    m_Bits = mp_Words[m_Word].bits;
+                    if (m_Word + 1 == m_EndWord) m_Bits &= m_TailMask;
+                    if (m_Bits != 0) return;
                 }
             }
-            return *this;
-        }
+        };
 
-        ~BitArray() noexcept override {
-            delete[] m_Words;
-            m_Words = nullptr;
-        }
+        SetBits(const Word *words, const array_size_t start, const array_size_t end) noexcept
+            : mp_Words(words), m_Start(start), m_End(end) { }
 
-        [[nodiscard]] constexpr Word *getUnderlyingImplementation() const noexcept { return m_Words; }
+        [[nodiscard]] Iterator begin() const noexcept { return Iterator(mp_Words, m_Start, m_End); }
 
-        void setAll() noexcept override {
-            for (array_size_t i = 0; i < m_WordCount; ++i)
-                m_Words[i].bits = Word::ALL_BITS_SET;
+        [[nodiscard]] Iterator end() const noexcept {
+            Iterator end;
+            end.m_Word = m_Start < m_End ? (m_End + Word::length - 1) / Word::length : 0;
+            return end;
         }
 
-        void clearAll() noexcept override {
-            for (array_size_t i = 0; i < m_WordCount; ++i)
-                m_Words[i].bits = 0;
-        }
+    private:
+        const Word *mp_Words;
+        array_size_t m_Start;
+        array_size_t m_End;
+    };
 
-        void assign(const array_size_t index, const bool value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+    /**
+     * Fixed-size bit array with native 64-bit words stored in cache line aligned memory.<br>
+     * Not polymorphic, so that accesses inline; use `BitArrayAdapter` where `BitArrayInterface` is required.
+     */
+    class BitArray final {
+    public:
+        explicit BitArray(const array_size_t size) noexcept : m_Size(size),
+                                                     m_WordCount((size + Word::length - 1) / Word::length),
+                                                     m_Words(allocate(m_WordCount)) { }
+
+        BitArray(const BitArray& other) noexcept : m_Size(other.m_Size),
+                                          m_WordCount(other.m_WordCount),
+                                          m_Words(allocate(m_WordCount)) {
+            std::copy_n(other.m_Words, m_WordCount, m_Words);
         }
 
-        void assign(const array_size_t index, const uint8_t value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+        BitArray(BitArray&& other) noexcept : m_Size(std::exchange(other.m_Size, 0)),
+                                     m_WordCount(std::exchange(other.m_WordCount, 0)),
+                                     m_Words(std::exchange(other.m_Words, nullptr)) { }
+
+        BitArray& operator=(const BitArray& rhs) noexcept {
+            if (this == &rhs) [[unlikely]] return *this;
+            if (capacity(m_WordCount) != capacity(rhs.m_WordCount)) {
+                deallocate(m_Words);
+                m_Words = allocate(rhs.m_WordCount);
+            }
+            m_Size = rhs.m_Size;
+            m_WordCount = rhs.m_WordCount;
+            std::copy_n(rhs.m_Words, m_WordCount, m_Words);
+            return *this;
         }
 
-        void assign(const array_size_t index, const int8_t value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+        BitArray& operator=(BitArray&& rhs) noexcept {
+            if (this == &rhs) [[unlikely]] return *this;
+            deallocate(m_Words);
+            m_Size = std::exchange(rhs.m_Size, 0);
+            m_WordCount = std::exchange(rhs.m_WordCount, 0);
+            m_Words = std::exchange(rhs.m_Words, nullptr);
+            return *this;
         }
 
-        void assign(const array_size_t index, const uint16_t value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+        ~BitArray() noexcept {
+            deallocate(m_Words);
+            m_Words = nullptr;
         }
 
-        void assign(const array_size_t index, const int16_t value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+        [[nodiscard]] array_size_t size() const noexcept { return m_Size; }
+
+        [[nodiscard]] constexpr Word *getUnderlyingImplementation() const noexcept { return m_Words; }
+
+        [[nodiscard]] constexpr array_size_t wordCount() const noexcept { return m_WordCount; }
+
+        [[nodiscard]] std::string getStringRepresentation() const noexcept {
+            std::string str;
+            str.reserve(m_Size);
+            for (array_size_t i = 0; i < m_Size; ++i)
+                str.push_back(getCharRepresentation(i));
+            return str;
         }
 
-        void assign(const array_size_t index, const uint32_t value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+        [[nodiscard]] char getCharRepresentation(const array_size_t index) const noexcept {
+            return BIT_CHAR_REPRESENTATIONS[get(index)];
         }
 
-        void assign(const array_size_t index, const int32_t value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+        void setAll() noexcept {
+            for (array_size_t i = 0; i < m_WordCount; ++i)
+                m_Words[i].bits = Word::ALL_BITS_SET;
+            if (const auto remainingBits = bitIndex(m_Size); remainingBits > 0)
+                m_Words[m_WordCount - 1].bits &= (static_cast<Word::word_t>(1) << remainingBits) - 1;
         }
 
-        void assign(const array_size_t index, const uint64_t value) noexcept override {
-            const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+        void clearAll() noexcept {
+            for (array_size_t i = 0; i < m_WordCount; ++i)
+                m_Words[i].bits = 0;
         }
 
-        void assign(const array_size_t index, const int64_t value) noexcept override {
+        /**
+         * Assigns the lowest bit of `value`.
+         */
+        template<std::integral T>
+        void assign(const array_size_t index, const T value) noexcept {
+            assert(index < m_Size && "Index out of bounds");
             const Word::word_t mask = static_cast<Word::word_t>(1) << bitIndex(index);
-            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value)) & mask;
+            m_Words[wordIndex(index)] ^= (m_Words[wordIndex(index)] ^ -static_cast<Word::word_t>(value & 1)) & mask;
         }
 
-        void set(const array_size_t index) noexcept override {
+        void set(const array_size_t index) noexcept {
+            assert(index < m_Size && "Index out of bounds");
             m_Words[wordIndex(index)] |= static_cast<Word::word_t>(1) << bitIndex(index);
         }
 
-        void clear(const array_size_t index) noexcept override {
+        void clear(const array_size_t index) noexcept {
+            assert(index < m_Size && "Index out of bounds");
             m_Words[wordIndex(index)] &= ~(static_cast<Word::word_t>(1) << bitIndex(index));
         }
 
-        void assignWord(const array_size_t index, const uint64_t word) noexcept override {
+        /**
+         * Writes 64 bits starting at `index`; bits past the last word are dropped.
+         */
+        void assignWord(const array_size_t index, const uint64_t word) noexcept {
             const array_size_t wordIndex = BitArray::wordIndex(index);
             const array_size_t bitIndex = BitArray::bitIndex(index);
             assert(wordIndex < m_WordCount && "Word index out of bounds");
-            assert(Word::BYTE_SIZE == 4 && "Word implementation has changed");
             if (bitIndex == 0) {
-                m_Words[wordIndex].bits = static_cast<Word::word_t>(word);
-                if (wordIndex + 1 < m_WordCount) {
-                    m_Words[wordIndex + 1].bits = static_cast<Word::word_t>(word >> Word::length);
-                }
-            } else {
-                m_Words[wordIndex].bits = (m_Words[wordIndex].bits & ((static_cast<Word::word_t>(1) << bitIndex) - 1))
-                    | static_cast<Word::word_t>(word << bitIndex);
-                if (wordIndex + 1 < m_WordCount) {
-                    m_Words[wordIndex + 1].bits = (m_Words[wordIndex + 1].bits & (Word::ALL_BITS_SET >> (~(Word::length
-                            - bitIndex))))
-                        | static_cast<Word::word_t>(word >> (Word::length - bitIndex));
-                }
-                if (wordIndex + 2 < m_WordCount) {
-                    m_Words[wordIndex + 2].bits = (m_Words[wordIndex + 2].bits & (Word::ALL_BITS_SET >> (~(Word::length
-                            - bitIndex))))
-                        | static_cast<Word::word_t>(word >> (Word::length * 2 - bitIndex));
-                }
+                m_Words[wordIndex].bits = word;
+                return;
+            }
+            const Word::word_t lowMask = (static_cast<Word::word_t>(1) << bitIndex) - 1;
+            m_Words[wordIndex].bits = (m_Words[wordIndex].bits & lowMask) | word << bitIndex;
+            if (wordIndex + 1 < m_WordCount) {
+                m_Words[wordIndex + 1].bits = (m_Words[wordIndex + 1].bits & ~lowMask) | word >> (Word::length - bitIndex);
+            }
+        }
+
+        /**
+         * Writes the low `n` bits of `word` from `index` on, leaving other bits intact.
+         */
+        void assignWordn(const array_size_t index, const uint64_t word, const uint8_t n) noexcept {
+            assert(n <= 64 && "Max word length is 64 bits");
+            if (n == 0) [[unlikely]] return;
+            const array_size_t wordIndex = BitArray::wordIndex(index);
+            const array_size_t bitIndex = BitArray::bitIndex(index);
+            assert(wordIndex < m_WordCount && "Word index out of bounds");
+            const Word::word_t mask = Word::ALL_BITS_SET >> (Word::length - n);
+            const Word::word_t bits = word & mask;
+            m_Words[wordIndex].bits = (m_Words[wordIndex].bits & ~(mask << bitIndex)) | bits << bitIndex;
+            if (bitIndex + n > Word::length) {
+                const array_size_t shift = Word::length - bitIndex;
+                m_Words[wordIndex + 1].bits = (m_Words[wordIndex + 1].bits & ~(mask >> shift)) | bits >> shift;
             }
         }
 
-        [[nodiscard]] uint8_t get(const array_size_t index) const noexcept override {
-            return static_cast<uint8_t>((m_Words[wordIndex(index)] & static_cast<Word::word_t>(1) << bitIndex(index)) >>
-                bitIndex(index));
+        /**
+         * Toggles the bits of `mask` in word `wordIndex` (a word index, not a bit index).
+         */
+        void flipWord(const array_size_t wordIndex, const uint64_t mask) noexcept {
+            assert(wordIndex < m_WordCount && "Word index out of bounds");
+            m_Words[wordIndex].bits ^= mask;
         }
 
-        uint8_t operator[](const array_size_t index) const noexcept override {
-            return static_cast<uint8_t>((m_Words[wordIndex(index)] & static_cast<Word::word_t>(1) << bitIndex(index)) >>
-                bitIndex(index));
+        [[nodiscard]] uint8_t get(const array_size_t index) const noexcept {
+            assert(index < m_Size && "Index out of bounds");
+            return static_cast<uint8_t>(m_Words[wordIndex(index)].bits >> bitIndex(index) & 1);
         }
 
-        [[nodiscard]] uint64_t word(const array_size_t index) const noexcept override {
+        uint8_t operator[](const array_size_t index) const noexcept { return get(index); }
+
+        /**
+         * Reads 64 bits starting at `index`; bits past the last word read as zero.
+         */
+        [[nodiscard]] uint64_t word(const array_size_t index) const noexcept {
             const array_size_t wordIndex = BitArray::wordIndex(index);
             const array_size_t bitIndex = BitArray::bitIndex(index);
             assert(wordIndex < m_WordCount && "Word index out of bounds");
-            assert(Word::BYTE_SIZE == 4 && "Word implementation has changed");
-            if (bitIndex == 0) {
-                if (wordIndex + 1 >= m_WordCount)
-                    return m_Words[wordIndex].bits;
-                return static_cast<uint64_t>(m_Words[wordIndex].bits) | static_cast<uint64_t>(m_Words[wordIndex + 1].
-                    bits) << Word::length;
-            }
-            if (wordIndex + 1 >= m_WordCount) { return m_Words[wordIndex].bits >> bitIndex; }
-            if (wordIndex + 2 >= m_WordCount) {
-                return static_cast<uint64_t>(m_Words[wordIndex].bits) >> bitIndex | static_cast<uint64_t>(m_Words[
-                    wordIndex + 1].bits) << Word::length - bitIndex;
-            }
-            return static_cast<uint64_t>(m_Words[wordIndex].bits) >> bitIndex | static_cast<uint64_t>(m_Words[wordIndex
-                    + 1].bits) << Word::length - bitIndex | static_cast<uint64_t>(m_Words[wordIndex + 2].bits) << 2 *
-                Word::length - bitIndex;
+            if (bitIndex == 0) return m_Words[wordIndex].bits;
+            const uint64_t low = m_Words[wordIndex].bits >> bitIndex;
+            if (wordIndex + 1 >= m_WordCount) return low;
+            return low | m_Words[wordIndex + 1].bits << (Word::length - bitIndex);
         }
 
-        [[nodiscard]] uint64_t wordn(const array_size_t index, const uint8_t n) const noexcept override {
+        [[nodiscard]] uint64_t wordn(const array_size_t index, const uint8_t n) const noexcept {
             assert(n <= 64 && "Max word length is 64 bits");
-            return word(index) & (1 << n) - 1;
+            return n == 64 ? word(index) : word(index) & ((static_cast<uint64_t>(1) << n) - 1);
         }
 
-        void copyTo(BitArrayInterface& other, const array_size_t srcOffset, const array_size_t srcStride,
-                    const array_size_t dstOffset) const noexcept override {
+        void copyTo(BitArray& dst, const array_size_t srcOffset, const array_size_t srcStride,
+                    const array_size_t dstOffset) const noexcept {
             assert(srcStride > 0 && "Stride must be larger than 0");
-            auto& array = static_cast<BitArray&>(other); // NOLINT(*-pro-type-static-cast-downcast)
-
-            array_size_t dstIdx = dstOffset;
-            for (array_size_t srcIdx = srcOffset; srcIdx < m_Size && dstIdx < array.m_Size; srcIdx += srcStride) {
-                array.assign(dstIdx++, get(srcIdx));
+            if (srcStride == 1 && srcOffset < m_Size && dstOffset < dst.m_Size) {
+                // Contiguous copy, a word at a time.
+                const array_size_t length = std::min(m_Size - srcOffset, dst.m_Size - dstOffset);
+                array_size_t i = 0;
+                for (; i + Word::length <= length; i += Word::length) dst.assignWord(dstOffset + i, word(srcOffset + i));
+                for (; i < length; ++i) dst.assign(dstOffset + i, get(srcOffset + i));
+                return;
+            }
+            if (srcOffset >= m_Size || dstOffset >= dst.m_Size) return;
+            // Strided copy, gathering up to a word of bits at a time.
+            const array_size_t length = std::min((m_Size - srcOffset + srcStride - 1) / srcStride, dst.m_Size - dstOffset);
+            for (array_size_t i = 0; i < length; i += Word::length) {
+                const auto n = static_cast<uint8_t>(std::min<array_size_t>(Word::length, length - i));
+                const uint64_t start = srcOffset + static_cast<uint64_t>(i) * srcStride;
+                dst.assignWordn(dstOffset + i, Simd::gatherBits(data(), start, srcStride, n), n);
             }
         }
 
-        [[nodiscard]] ArrayIndexRange getDifferenceBounds(const BitArrayInterface& other) const noexcept override {
+        [[nodiscard]] ArrayIndexRange getDifferenceBounds(const BitArray& other) const noexcept {
             assert(m_Size == other.m_Size && "Can't get difference bounds (comparison) for different size bit arrays.");
             ArrayIndexRange result {};
-            for (array_size_t i = m_Size; i > 0; --i) {
-                if (get(i - 1) != other.get(i - 1))
-                    result.start = i - 1;
-            }
-            for (array_size_t i = 0; i < m_Size; i++) {
-                if (get(i) != other.get(i))
-                    result.end = i - 1;
-            }
+            const array_size_t firstWord = findFirstDifferentWord(other);
+            if (firstWord == m_WordCount) return result;
+            array_size_t lastWord = m_WordCount - 1;
+            while (m_Words[lastWord].bits == other.m_Words[lastWord].bits) --lastWord;
+            result.start = firstWord * Word::length + std::countr_zero(m_Words[firstWord].bits ^ other.m_Words[firstWord].bits);
+            result.end = lastWord * Word::length + (Word::length - 1 - std::countl_zero(m_Words[lastWord].bits ^ other.m_Words[lastWord].bits)) - 1;
             return result;
         }
 
-        void random(const float probability) noexcept override {
+        /**
+         * @return Index of the first word at or after `startWord` that differs from the other (same size) array's, or
+         * `wordCount()` if there is none.
+         */
+        [[nodiscard]] array_size_t findFirstDifferentWord(const BitArray& other, const array_size_t startWord = 0) const noexcept {
+            assert(m_Size == other.m_Size && "Can't compare bit arrays of different sizes.");
+            if (startWord >= m_WordCount) [[unlikely]] return m_WordCount;
+            return startWord + Simd::findFirstDifferent(data() + startWord, other.data() + startWord, m_WordCount - startWord);
+        }
+
+        void random(const float probability) noexcept {
             std::random_device dev;
             std::mt19937 rng(dev());
             std::uniform_real_distribution<float> dist(std::numeric_limits<float>::min(), 1.0);
@@ -361,67 +463,251 @@ namespace BitArray {
             }
         }
 
-        void random() noexcept override {
+        void random() noexcept {
+            if (m_WordCount == 0) [[unlikely]] return;
             std::random_device dev;
-            std::mt19937 rng(dev());
-            std::uniform_int_distribution<std::mt19937::result_type> dist(0, Word::ALL_BITS_SET);
-            for (array_size_t i = 0; i < m_WordCount - 1; ++i) { m_Words[i].bits = dist(rng); }
-            m_Words[m_WordCount - 1].bits = dist(rng) & (static_cast<Word::word_t>(1) << m_Size % m_WordCount) - 1;
+            std::mt19937_64 rng(dev());
+            for (array_size_t i = 0; i < m_WordCount; ++i) { m_Words[i].bits = rng(); }
+            if (const auto remainingBits = bitIndex(m_Size); remainingBits > 0)
+                m_Words[m_WordCount - 1].bits &= (static_cast<Word::word_t>(1) << remainingBits) - 1;
         }
 
-        [[nodiscard]] bool test(const array_size_t index, const array_size_t length) const noexcept override {
+        [[nodiscard]] bool test(const array_size_t index, const array_size_t length) const noexcept {
             assert(index + length <= m_Size && "Parameter (index and length) sum should not exceed array length.");
             const size_t iterationCount = length / Word::length;
             for (size_t i = 0; i < iterationCount; ++i) { if (word(index + i * Word::length)) return true; }
-            const auto remainingBits = static_cast<int8_t>(length & Word::length - 1);
+            const auto remainingBits = static_cast<uint8_t>(length & Word::length - 1);
             return remainingBits > 0 && wordn(index + iterationCount * Word::length, remainingBits);
         }
 
-        [[nodiscard]] array_size_t count() const noexcept override {
-            array_size_t count = 0;
-            for (array_size_t i = 0; i < m_WordCount; ++i) {
-                count += m_Words[i].countBits();
+        [[nodiscard]] array_size_t count() const noexcept { return Simd::countBits(data(), m_WordCount); }
+
+        /**
+         * Number of set bits in [start; start + length).
+         */
+        [[nodiscard]] array_size_t count(const array_size_t start, const array_size_t length) const noexcept {
+            assert(start + length <= m_Size && "Parameter (start and length) sum should not exceed array length.");
+            if (length == 0) [[unlikely]] return 0;
+            const array_size_t firstWord = wordIndex(start);
+            const array_size_t lastWord = wordIndex(start + length - 1);
+            const Word::word_t headMask = Word::ALL_BITS_SET << bitIndex(start);
+            const Word::word_t tailMask = Word::ALL_BITS_SET >> (Word::length - 1 - bitIndex(start + length - 1));
+            if (firstWord == lastWord) return countBits(m_Words[firstWord].bits & headMask & tailMask);
+            return countBits(m_Words[firstWord].bits & headMask)
+                + Simd::countBits(data() + firstWord + 1, lastWord - firstWord - 1)
+                + countBits(m_Words[lastWord].bits & tailMask);
+        }
+
+        /**
+         * Number of positions set in both this and the other (same size) array.
+         */
+        [[nodiscard]] array_size_t countCommon(const BitArray& other) const noexcept {
+            assert(m_Size == other.m_Size && "Can't compare bit arrays of different sizes.");
+            return Simd::countCommonBits(data(), other.data(), m_WordCount);
+        }
+
+        /**
+         * Number of positions where this and the other (same size) array differ.
+         */
+        [[nodiscard]] array_size_t countDifferences(const BitArray& other) const noexcept {
+            assert(m_Size == other.m_Size && "Can't compare bit arrays of different sizes.");
+            return Simd::countDifferentBits(data(), other.data(), m_WordCount);
+        }
+
+        /**
+         * @return Index of the first set bit at or after `start`, or `size()` if there is none.
+         */
+        [[nodiscard]] array_size_t findFirstSet(const array_size_t start = 0) const noexcept {
+            if (start >= m_Size) [[unlikely]] return m_Size;
+            const array_size_t firstWord = wordIndex(start);
+            if (const Word::word_t bits = m_Words[firstWord].bits & Word::ALL_BITS_SET << bitIndex(start); bits != 0)
+                return firstWord * Word::length + std::countr_zero(bits);
+            const array_size_t wordIndex = firstWord + 1 + Simd::findFirstNonZero(data() + firstWord + 1, m_WordCount - firstWord - 1);
+            if (wordIndex >= m_WordCount) return m_Size;
+            return wordIndex * Word::length + std::countr_zero(m_Words[wordIndex].bits);
+        }
+
+        BitArray& operator&=(const BitArray& other) noexcept { return apply<Simd::BitOperation::AND>(other); }
+        BitArray& operator|=(const BitArray& other) noexcept { return apply<Simd::BitOperation::OR>(other); }
+        BitArray& operator^=(const BitArray& other) noexcept { return apply<Simd::BitOperation::XOR>(other); }
+
+        /**
+         * Clears the bits that are set in the other array.
+         */
+        BitArray& andNot(const BitArray& other) noexcept { return apply<Simd::BitOperation::AND_NOT>(other); }
+
+        /**
+         * Applies `Operation` with a same-size array over all bits.
+         */
+        template<Simd::BitOperation Operation>
+        BitArray& apply(const BitArray& other) noexcept {
+            assert(m_Size == other.m_Size && "Can't combine bit arrays of different sizes.");
+            Simd::applyWords<Operation>(data(), other.data(), m_WordCount);
+            return *this;
+        }
+
+        /**
+         * Applies `Operation` with a same-size array over the bits in [start; start + length), leaving other bits intact.
+         */
+        template<Simd::BitOperation Operation>
+        BitArray& apply(const BitArray& other, const array_size_t start, const array_size_t length) noexcept {
+            assert(m_Size == other.m_Size && "Can't combine bit arrays of different sizes.");
+            assert(start + length <= m_Size && "Parameter (start and length) sum should not exceed array length.");
+            if (length == 0) [[unlikely]] return *this;
+            const array_size_t firstWord = wordIndex(start);
+            const array_size_t lastWord = wordIndex(start + length - 1);
+            const Word::word_t headMask = Word::ALL_BITS_SET << bitIndex(start);
+            const Word::word_t tailMask = Word::ALL_BITS_SET >> (Word::length - 1 - bitIndex(start + length - 1));
+            if (firstWord == lastWord) {
+                applyMasked<Operation>(firstWord, other.m_Words[firstWord].bits, headMask & tailMask);
+                return *this;
             }
-            return count;
+            applyMasked<Operation>(firstWord, other.m_Words[firstWord].bits, headMask);
+            Simd::applyWords<Operation>(data() + firstWord + 1, other.data() + firstWord + 1, lastWord - firstWord - 1);
+            applyMasked<Operation>(lastWord, other.m_Words[lastWord].bits, tailMask);
+            return *this;
+        }
+
+        /**
+         * @return Range over the indices of the set bits in [start; start + length).
+         */
+        [[nodiscard]] SetBits setBits(const array_size_t start, const array_size_t length) const noexcept {
+            assert(start + length <= m_Size && "Parameter (start and length) sum should not exceed array length.");
+            return SetBits(m_Words, start, start + length);
         }
 
+        [[nodiscard]] SetBits setBits() const noexcept { return SetBits(m_Words, 0, m_Size); }
+
         void collectTestIndices(const BitArray& other, const array_size_t offset,
                                 std::vector<array_size_t>& result) const noexcept {
-            const size_t iterationCount = other.m_Size >> 6; // 64 == 2^6
             if (result.capacity() == 0) [[unlikely]] result.reserve((other.m_Size >> 2) + 1);
-            for (size_t i = 0; i < iterationCount; ++i) {
-                uint64_t word = this->word(offset + (i << 6));
-                for (uint8_t j = 0; j < 64; ++j) {
-                    // ReSharper disable once CppRedundantParentheses
-                    if ((word & (1 << j)) == 0) continue;
-                    const array_size_t index = i << 6 | j;
-                    result.push_back(index);
-                }
-            }
-            if (const auto remainingBits = static_cast<int8_t>(other.m_Size & 63); remainingBits > 0) {
-                uint64_t word = this->wordn(iterationCount << 6, remainingBits);
-                for (uint8_t j = 0; j < remainingBits; ++j) {
-                    // ReSharper disable once CppRedundantParentheses
-                    if ((word & (1 << j)) == 0) continue;
-                    const array_size_t index = iterationCount << 6 | j;
-                    result.push_back(index);
-                }
-            }
+            for (const array_size_t index : setBits(offset, other.m_Size)) result.push_back(index - offset);
         }
 
     protected:
+        array_size_t m_Size;
         array_size_t m_WordCount;
         Word *m_Words;
 
         static constexpr array_size_t wordIndex(const array_size_t index) noexcept { return index / Word::length; }
 
         static constexpr array_size_t bitIndex(const array_size_t index) noexcept { return index % Word::length; }
+
+        /**
+         * Words as plain integers; `Word` is standard layout and pointer-interconvertible with its only member.
+         */
+        [[nodiscard]] uint64_t *data() const noexcept { return reinterpret_cast<uint64_t *>(m_Words); }
+
+        template<Simd::BitOperation Operation>
+        void applyMasked(const array_size_t wordIndex, const Word::word_t src, const Word::word_t mask) noexcept {
+            const Word::word_t dst = m_Words[wordIndex].bits;
+            m_Words[wordIndex].bits = (dst & ~mask) | (Simd::Scalar::apply<Operation>(dst, src) & mask);
+        }
+
+        /**
+         * Storage is rounded up to whole cache lines; padding words are zeroed and never read as array bits.
+         */
+        static constexpr array_size_t capacity(const array_size_t wordCount) noexcept {
+            return (wordCount + Word::WORDS_PER_CACHE_LINE - 1) / Word::WORDS_PER_CACHE_LINE * Word::WORDS_PER_CACHE_LINE;
+        }
+
+        static Word *allocate(const array_size_t wordCount) noexcept {
+            if (wordCount == 0) [[unlikely]] return nullptr;
+            const array_size_t wordCapacity = capacity(wordCount);
+            auto *words = static_cast<Word *>(::operator new[](wordCapacity * sizeof(Word), std::align_val_t{CACHE_LINE_SIZE}));
+            std::fill_n(words, wordCapacity, Word{0});
+            return words;
+        }
+
+        static void deallocate(Word *words) noexcept {
+            if (words == nullptr) return;
+            ::operator delete[](words, std::align_val_t{CACHE_LINE_SIZE});
+        }
+
+    private:
+        friend class BitMatrix::BitSymmetricalMatrix;
+        friend class BitMatrix::BitSquareMatrix;
+        friend class BitMatrix::BitMatrix;
+        friend class BitMatrix::BitMatrix3D;
+    };
+
+    /**
+     * Exposes a `BitArray` through the virtual `BitArrayInterface`, for code that needs runtime polymorphism.
+     * The adapter does not own the array.
+     */
+    class BitArrayAdapter final : public BitArrayInterface {
+    public:
+        explicit BitArrayAdapter(BitArray& array) noexcept : BitArrayInterface(array.size()), m_Array(array) { }
+
+        [[nodiscard]] BitArray& array() const noexcept { return m_Array; }
+
+        void setAll() noexcept override { m_Array.setAll(); }
+        void clearAll() noexcept override { m_Array.clearAll(); }
+
+        void assign(const array_size_t index, const bool value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const uint8_t value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const int8_t value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const uint16_t value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const int16_t value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const uint32_t value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const int32_t value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const uint64_t value) noexcept override { m_Array.assign(index, value); }
+        void assign(const array_size_t index, const int64_t value) noexcept override { m_Array.assign(index, value); }
+        void set(const array_size_t index) noexcept override { m_Array.set(index); }
+        void clear(const array_size_t index) noexcept override { m_Array.clear(index); }
+
+        void assignWord(const array_size_t index, const uint64_t word) noexcept override { m_Array.assignWord(index, word); }
+
+        [[nodiscard]] uint8_t get(const array_size_t index) const noexcept override { return m_Array.get(index); }
+
+        [[nodiscard]] uint64_t word(const array_size_t index) const noexcept override { return m_Array.word(index); }
+        [[nodiscard]] uint64_t wordn(const array_size_t index, const uint8_t n) const noexcept override { return m_Array.wordn(index, n); }
+
+        void copyTo(BitArrayInterface& dst, const array_size_t srcOffset, const array_size_t srcStride,
+                    const array_size_t dstOffset) const noexcept override {
+            assert(srcStride > 0 && "Stride must be larger than 0");
+            array_size_t dstIdx = dstOffset;
+            for (array_size_t srcIdx = srcOffset; srcIdx < m_Size && dstIdx < dst.size(); srcIdx += srcStride) {
+                dst.assign(dstIdx++, get(srcIdx));
+            }
+        }
+
+        [[nodiscard]] ArrayIndexRange getDifferenceBounds(const BitArrayInterface& other) const noexcept override {
+            assert(m_Size == other.size() && "Can't get difference bounds (comparison) for different size bit arrays.");
+            ArrayIndexRange result {};
+            for (array_size_t i = m_Size; i > 0; --i) {
+                if (get(i - 1) != other.get(i - 1))
+                    result.start = i - 1;
+            }
+            for (array_size_t i = 0; i < m_Size; i++) {
+                if (get(i) != other.get(i))
+                    result.end = i - 1;
+            }
+            return result;
+        }
+
+        void random(const float probability) noexcept override { m_Array.random(probability); }
+        void random() noexcept override { m_Array.random(); }
+
+        [[nodiscard]] bool test(const array_size_t index, const array_size_t length) const noexcept override {
+            return m_Array.test(index, length);
+        }
+
+        [[nodiscard]] array_size_t count() const noexcept override { return m_Array.count(); }
+
+    private:
+        BitArray& m_Array;
     };
 
     inline std::ostream& operator<<(std::ostream& out, const BitArrayInterface& array) noexcept {
         out << array.getStringRepresentation();
         return out;
     }
+
+    inline std::ostream& operator<<(std::ostream& out, const BitArray& array) noexcept {
+        out << array.getStringRepresentation();
+        return out;
+    }
 }
 
 #endif //BITARRAY_H
@@ -3,8 +3,10 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "ConstraintScore.h"
+#include "Moves/AssignmentCandidates.h"
 #include "Moves/AutonomousPerturbator.h"
 #include "State/State.h"
 
@@ -31,7 +33,76 @@ namespace Constraints {
 
         [[nodiscard]] const std::vector<Moves::AutonomousPerturbator<X, Y, Z, W> *>& getRepairPerturbators() const noexcept { return m_RepairPerturbators; }
 
-        virtual ConstraintScore evaluate(const ::State::State<X, Y, Z, W>& state) noexcept = 0;
+        /**
+         * Evaluates the state from scratch.
+         * @param state State to evaluate.
+         * @param mode Whether violations should be recorded.
+         * @return Constraint score of the given state.
+         */
+        virtual ConstraintScore evaluate(const ::State::State<X, Y, Z, W>& state, EvaluationMode mode) noexcept = 0;
+
+        ConstraintScore evaluate(const ::State::State<X, Y, Z, W>& state) noexcept {
+            return evaluate(state, EvaluationMode::FULL);
+        }
+
+        /**
+         * Axis by which this constraint decomposes into independent partitions, i.e., the constraint score is a sum of
+         * partition scores and a partition score depends only on the bits with the same coordinate on that axis.
+         * @return `::State::Area::X`, `Y`, `Z` or `W` if the constraint is partitioned; `0` otherwise.
+         * @see evaluatePartition
+         */
+        [[nodiscard]] virtual uint8_t partitionAxis() const noexcept { return 0; }
+
+        /**
+         * Evaluates a single partition of a partitioned constraint.
+         * @param state State to evaluate.
+         * @param partition Coordinate on the partition axis.
+         * @param mode Whether violations should be recorded.
+         * @return Constraint score of the given partition.
+         * @see partitionAxis
+         */
+        virtual ConstraintScore evaluatePartition(const ::State::State<X, Y, Z, W>& state, axis_size_t partition,
+                                                  const EvaluationMode mode) noexcept {
+            return ConstraintScore(mode);
+        }
+
+        /**
+         * Excludes the assignments this constraint always rejects, i.e. the ones that are a strict violation whatever
+         * else is assigned, so that moves don't sample them.
+         * @param candidates Candidates of the search; built after every constraint excluded its assignments.
+         */
+        virtual void excludeCandidates(Moves::AssignmentCandidates& candidates) const noexcept { }
+
+        /**
+         * Rebuilds cached partial results used by incremental evaluation for a committed (fully evaluated) state.
+         * Does not affect `evaluate`, which always evaluates from scratch.
+         * @param state Committed state.
+         */
+        virtual void resetDelta(const ::State::State<X, Y, Z, W>& state) noexcept { }
+
+        /**
+         * Evaluates the state incrementally relative to the last committed state. Partial results are staged until
+         * `commitDelta` or `rollbackDelta` is called. Default implementation falls back to full evaluation.
+         * @param state State with changes applied.
+         * @param flippedLocations Locations whose values differ from the committed state (each occurs once).
+         * @param mode Whether violations should be recorded.
+         * @return Constraint score of the given state.
+         */
+        virtual ConstraintScore evaluateDelta(const ::State::State<X, Y, Z, W>& state,
+                                              const std::vector<::State::Location>& flippedLocations,
+                                              const EvaluationMode mode) noexcept {
+            return evaluate(state, mode);
+        }
+
+        /**
+         * Makes the partial results staged by the last `evaluateDelta` call the committed ones.
+         */
+        virtual void commitDelta() noexcept { }
+
+        /**
+         * Discards the partial results staged by the last `evaluateDelta` call.
+         */
+        virtual void rollbackDelta() noexcept { }
 
     private:
         std::string m_Name;
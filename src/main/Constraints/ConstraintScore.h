@@ -14,21 +14,36 @@ namespace Constraints {
     using axis_size_t = ::State::axis_size_t;
     using state_size_t = ::State::state_size_t;
 
+    /**
+     * Defines what constraint evaluation produces.
+     */
+    enum class EvaluationMode : uint8_t {
+        /** Score and violations. */
+        FULL = 0,
+        /** Score only; violations are not recorded. */
+        SCORE_ONLY,
+    };
+
     class ConstraintScore {
     public:
         explicit ConstraintScore(const Score& score, std::vector<Violation>&& violations) noexcept : m_Score(score),
             m_Violations(std::move(violations)) { }
 
+        explicit ConstraintScore(const EvaluationMode mode) noexcept : m_RecordsViolations(mode == EvaluationMode::FULL) { }
+
         ConstraintScore() noexcept {}
 
-        ConstraintScore(const ConstraintScore& other) noexcept : m_Score(other.m_Score), m_Violations(other.m_Violations) {}
+        ConstraintScore(const ConstraintScore& other) noexcept : m_Score(other.m_Score), m_Violations(other.m_Violations),
+            m_RecordsViolations(other.m_RecordsViolations) {}
 
-        ConstraintScore(ConstraintScore&& other) noexcept : m_Score(std::move(other.m_Score)), m_Violations(std::move(other.m_Violations)) {}
+        ConstraintScore(ConstraintScore&& other) noexcept : m_Score(std::move(other.m_Score)), m_Violations(std::move(other.m_Violations)),
+            m_RecordsViolations(other.m_RecordsViolations) {}
 
         ConstraintScore& operator=(const ConstraintScore& other) noexcept {
             if (this != &other) {
                 m_Score = other.m_Score;
                 m_Violations = other.m_Violations;
+                m_RecordsViolations = other.m_RecordsViolations;
             }
             return *this;
         }
@@ -37,12 +52,18 @@ namespace Constraints {
             if (this != &other) {
                 m_Score = std::move(other.m_Score);
                 m_Violations = std::move(other.m_Violations);
+                m_RecordsViolations = other.m_RecordsViolations;
             }
             return *this;
         }
 
         [[nodiscard]] const Score& score() const noexcept { return m_Score; }
 
+        /**
+         * @return `true` if violations are recorded (evaluated in `EvaluationMode::FULL`), `false` otherwise.
+         */
+        [[nodiscard]] bool recordsViolations() const noexcept { return m_RecordsViolations; }
+
         [[nodiscard]] const std::vector<Violation>& violations() const noexcept { return m_Violations; }
 
         void addScore(const Score& score) noexcept { m_Score += score; }
@@ -75,12 +96,13 @@ namespace Constraints {
 
         void violate(Violation&& violation) noexcept {
             m_Score += violation.score;
-            m_Violations.emplace_back(std::forward<Violation>(violation));
+            if (m_RecordsViolations) m_Violations.emplace_back(std::forward<Violation>(violation));
         }
 
     protected:
         Score m_Score{};
         std::vector<Violation> m_Violations;
+        bool m_RecordsViolations = true;
 
         template<typename X, typename Y, typename Z, typename W>
         friend class ::Constraints::Constraint;
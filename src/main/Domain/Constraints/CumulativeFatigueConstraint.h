@@ -32,55 +32,24 @@ namespace Domain::Constraints {
 
         ~CumulativeFatigueConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state) noexcept override {
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
             #ifdef CUMULATIVEFATIGUECONSTRAINT_CONSTRAINT_DEBUG_INFO
             debug_MaxConsecutiveShiftsPerEmployee.clear();
-            debug_MaxConsecutiveShiftsPerEmployee.reserve(state.sizeY());
+            debug_MaxConsecutiveShiftsPerEmployee.resize(state.sizeY());
             #endif
 
-            ConstraintScore totalScore;
+            ConstraintScore totalScore(mode);
+            for (axis_size_t y = 0; y < state.sizeY(); ++y) evaluateEmployee(state, y, totalScore);
 
-            LastConsecutiveShift lastConsecutiveShift;
-
-            for (axis_size_t y = 0; y < state.sizeY(); ++y) {
-                #ifdef CUMULATIVEFATIGUECONSTRAINT_CONSTRAINT_DEBUG_INFO
-                DebugMaxConsecutiveShifts debug_MaxConsecutiveShifts {};
-                #endif
-
-                for (axis_size_t z = 0, nextXi = 0; z < state.sizeZ(); ++z) {
-                    // Find a starting point.
-                    lastConsecutiveShift.reset(z);
-                    for (axis_size_t xi = nextXi; xi < state.sizeX(); ++xi) {
-                        const auto x = m_SortedShiftIndices[xi];
-                        if (!state.get(x, y, z)) continue;
-                        const auto& shift = state.x()[x];
-                        const auto& interval = shift.interval();
-                        lastConsecutiveShift.updateCumulativeEnd(0, shift.consecutiveRestMinutes(), interval);
-                        lastConsecutiveShift.count += 1;
-                        lastConsecutiveShift.totalDuration += static_cast<int64_t>(interval.durationInMinutes());
-                        lastConsecutiveShift.x = x;
-                        lastConsecutiveShift.xi = xi;
-                    }
-                    nextXi = 0;
-
-                    // Check shifts on consecutive days.
-                    evaluateConsecutiveShifts(state, lastConsecutiveShift, y, z, nextXi, totalScore);
+            return totalScore;
+        }
 
-                    #ifdef CUMULATIVEFATIGUECONSTRAINT_CONSTRAINT_DEBUG_INFO
-                    if (debug_MaxConsecutiveShifts.count < lastConsecutiveShift.count) {
-                        debug_MaxConsecutiveShifts.count = lastConsecutiveShift.count;
-                        debug_MaxConsecutiveShifts.z0 = lastConsecutiveShift.z0;
-                        debug_MaxConsecutiveShifts.z = lastConsecutiveShift.z;
-                        debug_MaxConsecutiveShifts.totalDuration = lastConsecutiveShift.totalDuration;
-                    }
-                    #endif
-                }
-
-                #ifdef CUMULATIVEFATIGUECONSTRAINT_CONSTRAINT_DEBUG_INFO
-                debug_MaxConsecutiveShiftsPerEmployee.push_back(debug_MaxConsecutiveShifts);
-                #endif
-            }
+        [[nodiscard]] uint8_t partitionAxis() const noexcept override { return ::State::Area::Y; }
 
+        [[nodiscard]] ConstraintScore evaluatePartition(const State::DomainState& state, const axis_size_t y,
+                                                        const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            evaluateEmployee(state, y, totalScore);
             return totalScore;
         }
 
@@ -148,6 +117,48 @@ namespace Domain::Constraints {
         std::vector<DebugMaxConsecutiveShifts> debug_MaxConsecutiveShiftsPerEmployee;
         #endif
 
+        void evaluateEmployee(const State::DomainState& state, const axis_size_t y, ConstraintScore& totalScore) noexcept {
+            #ifdef CUMULATIVEFATIGUECONSTRAINT_CONSTRAINT_DEBUG_INFO
+            DebugMaxConsecutiveShifts debug_MaxConsecutiveShifts {};
+            #endif
+
+            LastConsecutiveShift lastConsecutiveShift;
+
+            for (axis_size_t z = 0, nextXi = 0; z < state.sizeZ(); ++z) {
+                // Find a starting point.
+                lastConsecutiveShift.reset(z);
+                for (axis_size_t xi = nextXi; xi < state.sizeX(); ++xi) {
+                    const auto x = m_SortedShiftIndices[xi];
+                    if (!state.get(x, y, z)) continue;
+                    const auto& shift = state.x()[x];
+                    const auto& interval = shift.interval();
+                    lastConsecutiveShift.updateCumulativeEnd(0, shift.consecutiveRestMinutes(), interval);
+                    lastConsecutiveShift.count += 1;
+                    lastConsecutiveShift.totalDuration += static_cast<int64_t>(interval.durationInMinutes());
+                    lastConsecutiveShift.x = x;
+                    lastConsecutiveShift.xi = xi;
+                }
+                nextXi = 0;
+
+                // Check shifts on consecutive days.
+                evaluateConsecutiveShifts(state, lastConsecutiveShift, y, z, nextXi, totalScore);
+
+                #ifdef CUMULATIVEFATIGUECONSTRAINT_CONSTRAINT_DEBUG_INFO
+                if (debug_MaxConsecutiveShifts.count < lastConsecutiveShift.count) {
+                    debug_MaxConsecutiveShifts.count = lastConsecutiveShift.count;
+                    debug_MaxConsecutiveShifts.z0 = lastConsecutiveShift.z0;
+                    debug_MaxConsecutiveShifts.z = lastConsecutiveShift.z;
+                    debug_MaxConsecutiveShifts.totalDuration = lastConsecutiveShift.totalDuration;
+                }
+                #endif
+            }
+
+            #ifdef CUMULATIVEFATIGUECONSTRAINT_CONSTRAINT_DEBUG_INFO
+            if (debug_MaxConsecutiveShiftsPerEmployee.size() <= y) debug_MaxConsecutiveShiftsPerEmployee.resize(y + 1);
+            debug_MaxConsecutiveShiftsPerEmployee[y] = debug_MaxConsecutiveShifts;
+            #endif
+        }
+
         void evaluateConsecutiveShifts(const State::DomainState& state, LastConsecutiveShift& lastConsecutiveShift,
                                        const axis_size_t y, axis_size_t& z, axis_size_t& nextXi,
                                        ConstraintScore& totalScore) const noexcept {
@@ -19,6 +19,7 @@ namespace Domain::Constraints {
 
     using Score = ::Score::Score;
     using ConstraintScore = ::Constraints::ConstraintScore;
+    using EvaluationMode = ::Constraints::EvaluationMode;
     using Violation = ::Constraints::Violation;
 }
 
@@ -3,7 +3,11 @@
 
 #include "DomainConstraint.h"
 
-#include "Array/BitMatrix.h"
+#include "Array/BitArray.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
 
 namespace Domain::Constraints {
     class EmployeeAvailabilityConstraint final : public DomainConstraint {
@@ -15,11 +19,13 @@ namespace Domain::Constraints {
             Constraint("EMPLOYEE_AVAILABILITY", {
                 new Moves::DomainUnassignRepairPerturbator(),
             }),
-            m_IntersectingEmployeeUnavailabilitiesAndShifts(
-                BitMatrix::BitMatrix3D(xAxis.size(), yAxis.size(), zAxis.size())),
-            m_IntersectingEmployeeDesiredAvailabilitiesAndShifts(
-                BitMatrix::BitMatrix3D(xAxis.size(), yAxis.size(), zAxis.size())),
-            m_SpecificRequests(std::vector<std::vector<std::vector<int8_t>>>(xAxis.size(), std::vector<std::vector<int8_t>>(yAxis.size(), std::vector<int8_t>(zAxis.size())))) {
+            m_YSize(yAxis.size()),
+            m_ZSize(zAxis.size()),
+            m_UnavailableMask(xAxis.size() * yAxis.size() * zAxis.size()),
+            m_DesiredMask(xAxis.size() * yAxis.size() * zAxis.size()),
+            m_SpecificRequestOffsets(yAxis.size() + 1, 0) {
+            std::vector<int8_t> specificRequestWeights(xAxis.size() * yAxis.size() * zAxis.size(), 0);
+
             for (axis_size_t y = 0; y < yAxis.size(); ++y) {
                 const auto& e = yAxis[y];
 
@@ -33,56 +39,129 @@ namespace Domain::Constraints {
 
                         if (e.paidUnavailableAvailability().m_RangeCollection.intersects(shiftRange)
                             || e.unpaidUnavailableAvailability().m_RangeCollection.intersects(shiftRange)) {
-                            m_IntersectingEmployeeUnavailabilitiesAndShifts.set(x, y, z);
+                            m_UnavailableMask.set(index(x, y, z));
                         } else if (e.desiredAvailability().m_RangeCollection.intersects(shiftRange)) {
-                            m_IntersectingEmployeeDesiredAvailabilitiesAndShifts.set(x, y, z);
+                            m_DesiredMask.set(index(x, y, z));
                         }
                     }
                 }
 
                 for (const auto& specificRequest : e.desiredAvailability().m_SpecificRequests) {
-                    m_SpecificRequests[specificRequest.shiftIndex][y][specificRequest.dayIndex] = specificRequest.weight;
+                    specificRequestWeights[index(specificRequest.shiftIndex, y, specificRequest.dayIndex)] = specificRequest.weight;
                 }
                 for (const auto& specificRequest : e.paidUnavailableAvailability().m_SpecificRequests) {
-                    m_SpecificRequests[specificRequest.shiftIndex][y][specificRequest.dayIndex] = -specificRequest.weight; // NOLINT(*-narrowing-conversions)
+                    specificRequestWeights[index(specificRequest.shiftIndex, y, specificRequest.dayIndex)] = -specificRequest.weight; // NOLINT(*-narrowing-conversions)
                 }
                 for (const auto& specificRequest : e.unpaidUnavailableAvailability().m_SpecificRequests) {
-                    m_SpecificRequests[specificRequest.shiftIndex][y][specificRequest.dayIndex] = -specificRequest.weight; // NOLINT(*-narrowing-conversions)
+                    specificRequestWeights[index(specificRequest.shiftIndex, y, specificRequest.dayIndex)] = -specificRequest.weight; // NOLINT(*-narrowing-conversions)
                 }
             }
+
+            // Specific requests are rare; only nonzero cells are kept, grouped by employee.
+            for (axis_size_t y = 0; y < yAxis.size(); ++y) {
+                for (axis_size_t x = 0; x < xAxis.size(); ++x) {
+                    for (axis_size_t z = 0; z < zAxis.size(); ++z) {
+                        if (const int8_t weight = specificRequestWeights[index(x, y, z)]; weight != 0)
+                            m_SpecificRequests.emplace_back(SpecificRequest{x, z, weight});
+                    }
+                }
+                m_SpecificRequestOffsets[y + 1] = m_SpecificRequests.size();
+            }
         }
 
         ~EmployeeAvailabilityConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(
-            const State::DomainState& state) noexcept override {
-            ConstraintScore totalScore;
-            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
-                    for (axis_size_t y = 0; y < state.sizeY(); ++y) {
-                        if (!state.get(x, y, z)) continue;
-                        if (m_IntersectingEmployeeUnavailabilitiesAndShifts.get(x, y, z)) {
-                            totalScore.violate(Violation::xyz(x, y, z, {-1}));
-                        }
-                        if (m_IntersectingEmployeeDesiredAvailabilitiesAndShifts.get(x, y, z)) {
-                            totalScore.addSoftScore(1);
-                        }
-                        if (const int8_t specificRequestWeight = m_SpecificRequests[x][y][z]; specificRequestWeight < 0) {
-                            totalScore.violate(Violation::xyz(x, y, z, {0, 0, static_cast<score_t>(specificRequestWeight)}));
-                        } else if (specificRequestWeight > 0) {
-                            totalScore.addSoftScore(static_cast<score_t>(specificRequestWeight));
-                        }
+        void excludeCandidates(::Moves::AssignmentCandidates& candidates) const noexcept override {
+            for (axis_size_t x = 0; x < candidates.size().width; ++x) {
+                for (axis_size_t y = 0; y < m_YSize; ++y) {
+                    for (axis_size_t z = 0; z < m_ZSize; ++z) {
+                        if (m_UnavailableMask.get(index(x, y, z))) candidates.exclude(x, y, z, ::State::ANY);
                     }
                 }
             }
+        }
+
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            if (state.tracksProjection() && !totalScore.recordsViolations()) {
+                // The projection and the masks share the (x, y, z) index, so they are matched as whole arrays.
+                totalScore.addSoftScore(static_cast<score_t>(state.projection().countCommon(m_DesiredMask)));
+                totalScore.addStrictScore(-static_cast<score_t>(state.projection().countCommon(m_UnavailableMask)));
+                for (axis_size_t y = 0; y < state.sizeY(); ++y) evaluateSpecificRequests(state, y, totalScore);
+                return totalScore;
+            }
+            for (axis_size_t y = 0; y < state.sizeY(); ++y) evaluateEmployee(state, y, totalScore);
+
+            return totalScore;
+        }
+
+        [[nodiscard]] uint8_t partitionAxis() const noexcept override { return ::State::Area::Y; }
 
+        [[nodiscard]] ConstraintScore evaluatePartition(const State::DomainState& state, const axis_size_t y,
+                                                        const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            evaluateEmployee(state, y, totalScore);
             return totalScore;
         }
 
     private:
-        BitMatrix::BitMatrix3D m_IntersectingEmployeeUnavailabilitiesAndShifts;
-        BitMatrix::BitMatrix3D m_IntersectingEmployeeDesiredAvailabilitiesAndShifts;
-        std::vector<std::vector<std::vector<int8_t>>> m_SpecificRequests;
+        struct SpecificRequest {
+            axis_size_t x, z;
+            int8_t weight;
+        };
+
+        const axis_size_t m_YSize, m_ZSize;
+        BitArray::BitArray m_UnavailableMask; // Per (x, y, z).
+        BitArray::BitArray m_DesiredMask; // Per (x, y, z).
+        std::vector<size_t> m_SpecificRequestOffsets; // Per y, into `m_SpecificRequests`.
+        std::vector<SpecificRequest> m_SpecificRequests;
+
+        [[nodiscard]] BitArray::array_size_t index(const axis_size_t x, const axis_size_t y, const axis_size_t z) const noexcept {
+            return (x * m_YSize + y) * m_ZSize + z;
+        }
+
+        void evaluateEmployee(const State::DomainState& state, const axis_size_t y, ConstraintScore& totalScore) const noexcept {
+            // Assigned days of a shift are read (or gathered) as 64-bit words and matched against the masks a word at a time.
+            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                for (axis_size_t z0 = 0; z0 < state.sizeZ(); z0 += 64) {
+                    const axis_size_t length = std::min<axis_size_t>(64, state.sizeZ() - z0);
+                    uint64_t assigned = 0;
+                    if (state.tracksProjection()) {
+                        assigned = state.projection().wordn(state.projectionIndex(x, y, z0), static_cast<uint8_t>(length));
+                    } else {
+                        for (axis_size_t z = 0; z < length; ++z) {
+                            assigned |= static_cast<uint64_t>(state.get(x, y, z0 + z)) << z;
+                        }
+                    }
+                    if (assigned == 0) continue;
+
+                    auto unavailable = assigned & m_UnavailableMask.word(index(x, y, z0));
+                    const auto desired = assigned & m_DesiredMask.word(index(x, y, z0));
+                    totalScore.addSoftScore(BitArray::countBits(desired));
+                    if (!totalScore.recordsViolations()) {
+                        totalScore.addStrictScore(-static_cast<score_t>(BitArray::countBits(unavailable)));
+                        continue;
+                    }
+                    for (; unavailable != 0; unavailable &= unavailable - 1) {
+                        totalScore.violate(Violation::xyz(x, y, z0 + std::countr_zero(unavailable), {-1}));
+                    }
+                }
+            }
+
+            evaluateSpecificRequests(state, y, totalScore);
+        }
+
+        void evaluateSpecificRequests(const State::DomainState& state, const axis_size_t y, ConstraintScore& totalScore) const noexcept {
+            for (size_t i = m_SpecificRequestOffsets[y]; i < m_SpecificRequestOffsets[y + 1]; ++i) {
+                const auto& [x, z, weight] = m_SpecificRequests[i];
+                if (!state.get(x, y, z)) continue;
+                if (weight < 0) {
+                    totalScore.violate(Violation::xyz(x, y, z, {0, 0, static_cast<score_t>(weight)}));
+                } else {
+                    totalScore.addSoftScore(static_cast<score_t>(weight));
+                }
+            }
+        }
     };
 }
 
@@ -2,6 +2,7 @@
 #define EMPLOYMENTMAXDURATIONCONSTRAINT_H
 
 #include <chrono>
+#include <tuple>
 
 #include "DomainConstraint.h"
 
@@ -48,128 +49,251 @@ namespace Domain::Constraints {
 
         ~EmploymentMaxDurationConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(
-            const State::DomainState& state) noexcept override {
-            ConstraintScore totalScore;
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
 
-            for (axis_size_t y = 0; y < state.sizeY(); ++y) {
-                const auto& e = state.y()[y];
-                const auto& totalChangeEvent = e.totalChangeEvent();
-
-                const auto maxTotalWorkloadDurationInMinutes = static_cast<int64_t>(totalChangeEvent.maxLoadHours * 60L);
-                const auto maxTotalWorkloadOvertimeDurationInMinutes = static_cast<int64_t>(totalChangeEvent.maxOvertimeHours * 60L);
-
-                int64_t totalDurationInMinutes {};
-                axis_size_t totalAssignedShiftCount {};
-                Violation::info_t info = 0;
-
-                for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                    const auto *s = e.skill(w);
-
-                    int64_t maxWorkloadDurationInMinutes = 0;
-                    int64_t maxWorkloadOvertimeDurationInMinutes = 0;
-                    int32_t maxShiftCount = 0;
-
-                    if (s != nullptr && s->strategy != Workload::Strategy::NONE) {
-                        maxShiftCount = s->event.maxShiftCount;
-                        maxWorkloadOvertimeDurationInMinutes = static_cast<int64_t>(s->event.maxOvertimeHours * 60L);
-                        if (s->strategy == Workload::Strategy::STATIC) {
-                            maxWorkloadDurationInMinutes = static_cast<int64_t>(static_cast<double>(
-                                m_WorkloadDurationInRange) * s->event.staticLoad);
-                        } else if (s->strategy == Workload::Strategy::DYNAMIC) {
-                            maxWorkloadDurationInMinutes = static_cast<int64_t>(s->event.dynamicLoadHours * 60L);
-                        }
-                    } else continue;
+            for (axis_size_t y = 0; y < state.sizeY(); ++y) evaluateEmployee(state, y, totalScore);
 
-                    int64_t durationInMinutes {};
-                    axis_size_t assignedShiftCount {};
+            return totalScore;
+        }
+
+        void resetDelta(const State::DomainState& state) noexcept override {
+            m_ZSize = state.sizeZ();
+            m_WSize = state.sizeW();
+            m_WorkloadLimits.resize(state.sizeY() * m_WSize);
+            m_Workloads.assign(state.sizeY() * m_WSize, WorkloadTotal {});
+            m_TotalWorkloads.assign(state.sizeY(), WorkloadTotal {});
+            m_EmployeeScores.assign(state.sizeY(), Score {});
+            m_EmployeeMarks.assign(state.sizeY(), 0);
+            m_CommittedScore = {};
 
+            for (axis_size_t y = 0; y < state.sizeY(); ++y) {
+                const auto& e = state.y()[y];
+                for (axis_size_t w = 0; w < m_WSize; ++w) {
+                    const size_t index = y * m_WSize + w;
+                    m_WorkloadLimits[index] = workloadLimit(e, w);
                     for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                        for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
-                            if (!state.get(x, y, z, w)) continue;
-                            assignedShiftCount += 1;
-                            // ReSharper disable once CppDFANullDereference
-                            durationInMinutes += static_cast<int64_t>(m_ShiftDurationInMinutes[x * state.sizeZ() +
-                                z]);
+                        for (axis_size_t z = 0; z < m_ZSize; ++z) {
+                            if (state.get(x, y, z, w)) addWorkload(index, x * m_ZSize + z, 1);
                         }
                     }
-
-                    totalDurationInMinutes += durationInMinutes;
-                    totalAssignedShiftCount += assignedShiftCount;
-
-                    // const int64_t diff = maxWorkloadDurationInMinutes - durationInMinutes; // available minutes
-                    // const int64_t diffScale = diff > 0 ? 2 : 1; // seems to balance workload between employees
-                    // info = diffScale;
-                    // const int64_t overtimeDiff = diff + maxWorkloadOvertimeDurationInMinutes;
-                    //
-                    // constexpr int64_t ABS_DIFF_ALLOWANCE = 3 * 60;
-                    // const int64_t absDiff = std::abs(diff);
-                    //
-                    // const score_t absHard = (absDiff - 1) * diffScale / ABS_DIFF_ALLOWANCE; // scale with larger differences
-                    //
-                    // const score_t strict = -(overtimeDiff < 0 || (maxShiftCount >= 0 && assignedShiftCount > maxShiftCount));
-                    // const score_t hard = maxShiftCount != 0 ? -(absHard * absHard) : 0;
-                    // // const score_t hard = -(maxShiftCount != 0 && absHard > 0) * 100 * diffScale;
-
-                    const int64_t overloadMinutes = durationInMinutes - maxWorkloadDurationInMinutes;
-                    const int64_t overtimeAvailable = maxWorkloadOvertimeDurationInMinutes;
-
-                    const bool shiftLimitExceeded = (maxShiftCount >= 0 && assignedShiftCount > maxShiftCount);
-                    const bool durationExceeded = (overloadMinutes > overtimeAvailable);
-                    info = 2 - (overloadMinutes >= overtimeAvailable);
-
-                    const score_t strict = -(shiftLimitExceeded || durationExceeded);
-
-                    // Sigmoid penalty: increases smoothly from 0 to -100
-                    const double overload = std::max<double>(0, overloadMinutes - overtimeAvailable);
-                    const score_t hard = durationExceeded
-                        ? static_cast<score_t>(-100.0 / (1.0 + std::exp(-0.01 * (overload - 60)))) // 60 mins is midpoint
-                        : 0;
-
-                    if (strict != 0 || hard != 0) { totalScore.violate(Violation::yw(y, w, {strict, hard}, info)); }
                 }
+                ConstraintScore employeeScore(EvaluationMode::SCORE_ONLY);
+                scoreEmployee(state, y, employeeScore);
+                m_EmployeeScores[y] = employeeScore.score();
+                m_CommittedScore += m_EmployeeScores[y];
+            }
+            m_StagedScore = m_CommittedScore;
+            m_StagedChanges.clear();
+            m_StagedEmployeeScores.clear();
+        }
 
-                score_t strict = -(totalChangeEvent.maxShiftCount >= 0 && totalAssignedShiftCount > totalChangeEvent.maxShiftCount);
-                score_t hard = 0;
-
-                if (!totalChangeEvent.anyDuration && (totalChangeEvent.maxShiftCount == -1 || totalChangeEvent.maxShiftCount > 0)) {
-                    // const int64_t diff = maxTotalWorkloadDurationInMinutes - totalDurationInMinutes;
-                    // const int64_t diffScale = diff > 0 ? 2 : 1; // seems to balance workload between employees
-                    // info = diffScale;
-                    // const int64_t overtimeDiff = diff + maxTotalWorkloadOvertimeDurationInMinutes;
-                    //
-                    // constexpr int64_t ABS_DIFF_ALLOWANCE = 3 * 60;
-                    // const int64_t absDiff = std::abs(diff);
-                    //
-                    // const score_t absHard = (absDiff - 1) * diffScale / ABS_DIFF_ALLOWANCE; // scale with larger differences
-                    //
-                    // strict = -(overtimeDiff < 0 || strict == -1);
-                    // hard = -(absHard * absHard);
-                    // // hard = -(absHard > 0) * 100 * diffScale;
-
-                    const int64_t overloadMinutes = totalDurationInMinutes - maxTotalWorkloadDurationInMinutes;
-                    const int64_t overtimeAvailable = maxTotalWorkloadOvertimeDurationInMinutes;
-
-                    const bool shiftLimitExceeded = (totalChangeEvent.maxShiftCount >= 0 && totalAssignedShiftCount > totalChangeEvent.maxShiftCount);
-                    const bool durationExceeded = (overloadMinutes > overtimeAvailable);
-                    info = 2 - (overloadMinutes >= overtimeAvailable);
-
-                    strict = -(shiftLimitExceeded || durationExceeded);
-
-                    // Sigmoid penalty: increases smoothly from 0 to -100
-                    const double overload = std::max<double>(0, overloadMinutes - overtimeAvailable);
-                    hard = durationExceeded
-                        ? static_cast<score_t>(-100.0 / (1.0 + std::exp(-0.01 * (overload - 60)))) // 60 mins is midpoint
-                        : 0;
-                }
+        [[nodiscard]] ConstraintScore evaluateDelta(const State::DomainState& state,
+                                                    const std::vector<::State::Location>& flippedLocations,
+                                                    const EvaluationMode mode) noexcept override {
+            // Workloads are updated in place; staged changes are kept so that they can be rolled back.
+            m_StagedChanges.clear();
+            m_StagedEmployeeScores.clear();
+            m_StagedScore = m_CommittedScore;
+            for (const auto& location : flippedLocations) {
+                const size_t index = location.y * m_WSize + location.w;
+                const size_t shift = location.x * m_ZSize + location.z;
+                const int32_t change = state.get(location) ? 1 : -1;
+                addWorkload(index, shift, change);
+                m_StagedChanges.emplace_back(index, shift, change);
+                if (m_EmployeeMarks[location.y]) continue;
+                m_EmployeeMarks[location.y] = 1;
+                m_StagedEmployeeScores.emplace_back(location.y, m_EmployeeScores[location.y]);
+            }
 
-                if (strict != 0 || hard != 0) { totalScore.violate(Violation::y(y, {strict, hard}, info)); }
+            for (const auto& [y, previousScore] : m_StagedEmployeeScores) {
+                m_EmployeeMarks[y] = 0;
+                ConstraintScore employeeScore(EvaluationMode::SCORE_ONLY);
+                scoreEmployee(state, y, employeeScore);
+                m_EmployeeScores[y] = employeeScore.score();
+                m_StagedScore += m_EmployeeScores[y] - previousScore;
             }
 
+            ConstraintScore totalScore(mode);
+            if (!totalScore.recordsViolations()) {
+                totalScore += m_StagedScore;
+                return totalScore;
+            }
+            for (axis_size_t y = 0; y < state.sizeY(); ++y) scoreEmployee(state, y, totalScore);
             return totalScore;
         }
 
+        void commitDelta() noexcept override {
+            m_CommittedScore = m_StagedScore;
+            m_StagedChanges.clear();
+            m_StagedEmployeeScores.clear();
+        }
+
+        void rollbackDelta() noexcept override {
+            for (const auto& [index, shift, change] : m_StagedChanges) addWorkload(index, shift, -change);
+            for (const auto& [y, previousScore] : m_StagedEmployeeScores) m_EmployeeScores[y] = previousScore;
+            m_StagedScore = m_CommittedScore;
+            m_StagedChanges.clear();
+            m_StagedEmployeeScores.clear();
+        }
+
     private:
+        struct WorkloadLimit {
+            bool enabled;
+            int64_t maxDurationInMinutes;
+            int64_t maxOvertimeDurationInMinutes;
+            int32_t maxShiftCount;
+        };
+
+        struct WorkloadTotal {
+            int64_t durationInMinutes;
+            int32_t assignedShiftCount;
+        };
+
+        [[nodiscard]] WorkloadLimit workloadLimit(const Domain::Employee& e, const axis_size_t w) const noexcept {
+            const auto *s = e.skill(w);
+            if (s == nullptr || s->strategy == Workload::Strategy::NONE) return WorkloadLimit {};
+
+            WorkloadLimit limit { true, 0, static_cast<int64_t>(s->event.maxOvertimeHours * 60L), s->event.maxShiftCount };
+            if (s->strategy == Workload::Strategy::STATIC) {
+                limit.maxDurationInMinutes = static_cast<int64_t>(static_cast<double>(
+                    m_WorkloadDurationInRange) * s->event.staticLoad);
+            } else if (s->strategy == Workload::Strategy::DYNAMIC) {
+                limit.maxDurationInMinutes = static_cast<int64_t>(s->event.dynamicLoadHours * 60L);
+            }
+            return limit;
+        }
+
+        void evaluateEmployee(const State::DomainState& state, const axis_size_t y, ConstraintScore& totalScore) const noexcept {
+            const auto& e = state.y()[y];
+
+            WorkloadTotal totalWorkload {};
+
+            for (axis_size_t w = 0; w < state.sizeW(); ++w) {
+                const auto limit = workloadLimit(e, w);
+                if (!limit.enabled) continue;
+
+                WorkloadTotal workload {};
+
+                for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                    for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
+                        if (!state.get(x, y, z, w)) continue;
+                        workload.assignedShiftCount += 1;
+                        workload.durationInMinutes += static_cast<int64_t>(m_ShiftDurationInMinutes[x * state.sizeZ() +
+                            z]);
+                    }
+                }
+
+                totalWorkload.durationInMinutes += workload.durationInMinutes;
+                totalWorkload.assignedShiftCount += workload.assignedShiftCount;
+
+                scoreSkill(y, w, limit, workload, totalScore);
+            }
+
+            scoreTotal(y, e.totalChangeEvent(), totalWorkload, totalScore);
+        }
+
+        /**
+         * Scores an employee from the running workload totals maintained by the delta evaluation.
+         */
+        void scoreEmployee(const State::DomainState& state, const axis_size_t y, ConstraintScore& totalScore) const noexcept {
+            for (axis_size_t w = 0; w < m_WSize; ++w) {
+                const size_t index = y * m_WSize + w;
+                if (!m_WorkloadLimits[index].enabled) continue;
+                scoreSkill(y, w, m_WorkloadLimits[index], m_Workloads[index], totalScore);
+            }
+            scoreTotal(y, state.y()[y].totalChangeEvent(), m_TotalWorkloads[y], totalScore);
+        }
+
+        static void scoreSkill(const axis_size_t y, const axis_size_t w, const WorkloadLimit& limit,
+                               const WorkloadTotal& workload, ConstraintScore& totalScore) noexcept {
+            // const int64_t diff = limit.maxDurationInMinutes - workload.durationInMinutes; // available minutes
+            // const int64_t diffScale = diff > 0 ? 2 : 1; // seems to balance workload between employees
+            // info = diffScale;
+            // const int64_t overtimeDiff = diff + limit.maxOvertimeDurationInMinutes;
+            //
+            // constexpr int64_t ABS_DIFF_ALLOWANCE = 3 * 60;
+            // const int64_t absDiff = std::abs(diff);
+            //
+            // const score_t absHard = (absDiff - 1) * diffScale / ABS_DIFF_ALLOWANCE; // scale with larger differences
+            //
+            // const score_t strict = -(overtimeDiff < 0 || (maxShiftCount >= 0 && assignedShiftCount > maxShiftCount));
+            // const score_t hard = maxShiftCount != 0 ? -(absHard * absHard) : 0;
+            // // const score_t hard = -(maxShiftCount != 0 && absHard > 0) * 100 * diffScale;
+
+            const int64_t overloadMinutes = workload.durationInMinutes - limit.maxDurationInMinutes;
+            const int64_t overtimeAvailable = limit.maxOvertimeDurationInMinutes;
+
+            const bool shiftLimitExceeded = (limit.maxShiftCount >= 0 && workload.assignedShiftCount > limit.maxShiftCount);
+            const bool durationExceeded = (overloadMinutes > overtimeAvailable);
+            const Violation::info_t info = 2 - (overloadMinutes >= overtimeAvailable);
+
+            const score_t strict = -(shiftLimitExceeded || durationExceeded);
+
+            // Sigmoid penalty: increases smoothly from 0 to -100
+            const double overload = std::max<double>(0, overloadMinutes - overtimeAvailable);
+            const score_t hard = durationExceeded
+                ? static_cast<score_t>(-100.0 / (1.0 + std::exp(-0.01 * (overload - 60)))) // 60 mins is midpoint
+                : 0;
+
+            if (strict != 0 || hard != 0) { totalScore.violate(Violation::yw(y, w, {strict, hard}, info)); }
+        }
+
+        static void scoreTotal(const axis_size_t y, const Workload::TotalChangeEvent& totalChangeEvent,
+                               const WorkloadTotal& totalWorkload, ConstraintScore& totalScore) noexcept {
+            const auto maxTotalWorkloadDurationInMinutes = static_cast<int64_t>(totalChangeEvent.maxLoadHours * 60L);
+            const auto maxTotalWorkloadOvertimeDurationInMinutes = static_cast<int64_t>(totalChangeEvent.maxOvertimeHours * 60L);
+            const int64_t totalDurationInMinutes = totalWorkload.durationInMinutes;
+            const int32_t totalAssignedShiftCount = totalWorkload.assignedShiftCount;
+            Violation::info_t info = 0;
+
+            score_t strict = -(totalChangeEvent.maxShiftCount >= 0 && totalAssignedShiftCount > totalChangeEvent.maxShiftCount);
+            score_t hard = 0;
+
+            if (!totalChangeEvent.anyDuration && (totalChangeEvent.maxShiftCount == -1 || totalChangeEvent.maxShiftCount > 0)) {
+                // const int64_t diff = maxTotalWorkloadDurationInMinutes - totalDurationInMinutes;
+                // const int64_t diffScale = diff > 0 ? 2 : 1; // seems to balance workload between employees
+                // info = diffScale;
+                // const int64_t overtimeDiff = diff + maxTotalWorkloadOvertimeDurationInMinutes;
+                //
+                // constexpr int64_t ABS_DIFF_ALLOWANCE = 3 * 60;
+                // const int64_t absDiff = std::abs(diff);
+                //
+                // const score_t absHard = (absDiff - 1) * diffScale / ABS_DIFF_ALLOWANCE; // scale with larger differences
+                //
+                // strict = -(overtimeDiff < 0 || strict == -1);
+                // hard = -(absHard * absHard);
+                // // hard = -(absHard > 0) * 100 * diffScale;
+
+                const int64_t overloadMinutes = totalDurationInMinutes - maxTotalWorkloadDurationInMinutes;
+                const int64_t overtimeAvailable = maxTotalWorkloadOvertimeDurationInMinutes;
+
+                const bool shiftLimitExceeded = (totalChangeEvent.maxShiftCount >= 0 && totalAssignedShiftCount > totalChangeEvent.maxShiftCount);
+                const bool durationExceeded = (overloadMinutes > overtimeAvailable);
+                info = 2 - (overloadMinutes >= overtimeAvailable);
+
+                strict = -(shiftLimitExceeded || durationExceeded);
+
+                // Sigmoid penalty: increases smoothly from 0 to -100
+                const double overload = std::max<double>(0, overloadMinutes - overtimeAvailable);
+                hard = durationExceeded
+                    ? static_cast<score_t>(-100.0 / (1.0 + std::exp(-0.01 * (overload - 60)))) // 60 mins is midpoint
+                    : 0;
+            }
+
+            if (strict != 0 || hard != 0) { totalScore.violate(Violation::y(y, {strict, hard}, info)); }
+        }
+
+        void addWorkload(const size_t index, const size_t shift, const int32_t change) noexcept {
+            const int64_t duration = change * static_cast<int64_t>(m_ShiftDurationInMinutes[shift]);
+            m_Workloads[index].durationInMinutes += duration;
+            m_Workloads[index].assignedShiftCount += change;
+            if (!m_WorkloadLimits[index].enabled) return;
+            auto& totalWorkload = m_TotalWorkloads[index / m_WSize];
+            totalWorkload.durationInMinutes += duration;
+            totalWorkload.assignedShiftCount += change;
+        }
+
         struct PartitionRange;
 
         const int32_t m_WorkdayCount;
@@ -180,6 +304,16 @@ namespace Domain::Constraints {
         std::vector<int32_t> m_ShiftDurationInMinutes;
         std::vector<PartitionRange> m_PartitionRanges;
 
+        axis_size_t m_ZSize{}, m_WSize{};
+        std::vector<WorkloadLimit> m_WorkloadLimits; // Per (y, w).
+        std::vector<WorkloadTotal> m_Workloads; // Per (y, w).
+        std::vector<WorkloadTotal> m_TotalWorkloads; // Per y, over skills with a workload limit.
+        std::vector<Score> m_EmployeeScores; // Per y.
+        std::vector<uint8_t> m_EmployeeMarks;
+        std::vector<std::tuple<size_t, size_t, int32_t>> m_StagedChanges;
+        std::vector<std::pair<axis_size_t, Score>> m_StagedEmployeeScores;
+        Score m_CommittedScore{}, m_StagedScore{};
+
         struct PartitionRange {
             axis_size_t start, end;
             int32_t workdayCount;
@@ -6,19 +6,24 @@
 #include "Array/BitSquareMatrix.h"
 #include "Array/BitSymmetricalMatrix.h"
 
+#include "Utils/SimdUtils.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
 namespace Domain::Constraints {
     class NoOverlapConstraint final : public DomainConstraint {
     public:
         explicit NoOverlapConstraint(const Axes::Axis<Domain::Shift>& xAxis) noexcept : Constraint("NO_OVERLAP", {
                                                                                    new Moves::DomainUnassignRepairPerturbator(),
                                                                                }),
-                                                                               m_IntersectingShiftsInSameDayMatrix(
-                                                                                   BitMatrix::createIdentitySymmetricalMatrix(
-                                                                                       xAxis.size())),
-                                                                               m_IntersectingShiftsInAdjacentDaysMatrix(
-                                                                                   BitMatrix::createSquareMatrix(
-                                                                                       xAxis.size())) {
+                                                                               m_WordsPerRow((xAxis.size() + 63) / 64),
+                                                                               m_SameDayConflictMasks(xAxis.size() * m_WordsPerRow, 0),
+                                                                               m_AdjacentDayConflictMasks(xAxis.size() * m_WordsPerRow, 0) {
             if (xAxis.size() == 0) [[unlikely]] return;
+            auto intersectingShiftsInSameDayMatrix = BitMatrix::createIdentitySymmetricalMatrix(xAxis.size());
+            auto intersectingShiftsInAdjacentDaysMatrix = BitMatrix::createSquareMatrix(xAxis.size());
             for (axis_size_t x1 = 0; x1 < xAxis.size() - 1; ++x1) {
                 const auto& s1 = xAxis[x1];
                 const auto& interval1 = s1.interval();
@@ -27,60 +32,113 @@ namespace Domain::Constraints {
                     const auto& interval2 = s2.interval();
 
                     if (interval1.intersectsInSameDay(interval2))
-                        m_IntersectingShiftsInSameDayMatrix.set(x1, x2);
+                        intersectingShiftsInSameDayMatrix.set(x1, x2);
                     if (interval1.intersectsOtherInNextDay(interval2) || s1.blocksShiftIndex(x2))
-                        m_IntersectingShiftsInAdjacentDaysMatrix.set(x1, x2);
+                        intersectingShiftsInAdjacentDaysMatrix.set(x1, x2);
                     if (interval1.intersectsOtherInPrevDay(interval2) || s2.blocksShiftIndex(x1))
-                        m_IntersectingShiftsInAdjacentDaysMatrix.set(x2, x1);
+                        intersectingShiftsInAdjacentDaysMatrix.set(x2, x1);
+                }
+            }
+
+            for (axis_size_t x1 = 0; x1 < xAxis.size(); ++x1) {
+                for (axis_size_t x2 = 0; x2 < xAxis.size(); ++x2) {
+                    if (x2 > x1 && intersectingShiftsInSameDayMatrix.get(x1, x2))
+                        setBit(&m_SameDayConflictMasks[x1 * m_WordsPerRow], x2);
+                    if (intersectingShiftsInAdjacentDaysMatrix.get(x1, x2) || intersectingShiftsInAdjacentDaysMatrix.get(x2, x1))
+                        setBit(&m_AdjacentDayConflictMasks[x1 * m_WordsPerRow], x2);
                 }
             }
         }
 
         ~NoOverlapConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(
-            const State::DomainState& state) noexcept override {
-            ConstraintScore totalScore;
-            for (axis_size_t y = 0; y < state.sizeY(); ++y) {
-                for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
-                    // Check same-day intersections
-                    for (axis_size_t x1 = 0; x1 < state.sizeX() - 1; ++x1) {
-                        if (!state.get(x1, y, z)) continue; // not assigned
-                        for (axis_size_t x2 = x1 + 1; x2 < state.sizeX(); ++x2) {
-                            if (!state.get(x2, y, z) || !m_IntersectingShiftsInSameDayMatrix.get(x1, x2))
-                                continue; // not assigned or not intersecting
-                            totalScore.violate(Violation::xyz(x1, y, z, {-1}));
-                            totalScore.violate(Violation::xyz(x2, y, z, {-1}));
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            for (axis_size_t y = 0; y < state.sizeY(); ++y) evaluateEmployee(state, y, totalScore);
+
+            return totalScore;
+        }
+
+        [[nodiscard]] uint8_t partitionAxis() const noexcept override { return ::State::Area::Y; }
+
+        [[nodiscard]] ConstraintScore evaluatePartition(const State::DomainState& state, const axis_size_t y,
+                                                        const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            evaluateEmployee(state, y, totalScore);
+            return totalScore;
+        }
+
+    private:
+        void evaluateEmployee(const State::DomainState& state, const axis_size_t y, ConstraintScore& totalScore) noexcept {
+            // Shift bitsets of every day; the assigned days of a shift are read as 64-bit words of the projection and
+            // scattered into them, so building them costs a word per 64 days and a bit per assignment.
+            m_AssignedShifts.assign(state.sizeZ() * m_WordsPerRow, 0);
+            if (state.tracksProjection()) {
+                for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                    for (axis_size_t z0 = 0; z0 < state.sizeZ(); z0 += 64) {
+                        const auto length = static_cast<uint8_t>(std::min<axis_size_t>(64, state.sizeZ() - z0));
+                        for (uint64_t days = state.projection().wordn(state.projectionIndex(x, y, z0), length); days != 0; days &= days - 1) {
+                            setBit(&m_AssignedShifts[(z0 + std::countr_zero(days)) * m_WordsPerRow], x);
                         }
                     }
+                }
+            } else {
+                for (const auto& location : state.setLocations(::State::ANY, y, ::State::ANY)) {
+                    setBit(&m_AssignedShifts[location.z * m_WordsPerRow], location.x);
+                }
+            }
+
+            for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
+                const uint64_t *currentDay = &m_AssignedShifts[z * m_WordsPerRow];
+                if (Simd::findFirstNonZero(currentDay, m_WordsPerRow) == m_WordsPerRow) continue;
+
+                // Check same-day intersections
+                forEachConflict(currentDay, currentDay, m_SameDayConflictMasks, y, z, totalScore);
+                // Check previous and next day intersections
+                if (z > 0) [[likely]] forEachConflict(currentDay - m_WordsPerRow, currentDay, m_AdjacentDayConflictMasks, y, z, totalScore);
+            }
+        }
 
-                    // Check previous and next day intersections
-                    if (z > 0) [[likely]] {
-                        for (axis_size_t x1 = 0; x1 < state.sizeX(); ++x1) {
-                            if (!state.get(x1, y, z - 1)) continue; // not assigned
-                            for (axis_size_t x2 = 0; x2 < state.sizeX(); ++x2) {
-                                if (!state.get(x2, y, z) || (!m_IntersectingShiftsInAdjacentDaysMatrix.get(x1, x2) && !
-                                    m_IntersectingShiftsInAdjacentDaysMatrix.get(x2, x1)))
-                                    continue; // not assigned or not intersecting
-                                totalScore.violate(Violation::xyz(x1, y, z, {-1}));
-                                totalScore.violate(Violation::xyz(x2, y, z, {-1}));
-                            }
+        /**
+         * Violates every pair (x1, x2) where x1 is set in `first`, x2 is set in `second` and x2 is set in the conflict
+         * mask row of x1.
+         */
+        void forEachConflict(const uint64_t *first, const uint64_t *second, const std::vector<uint64_t>& conflictMasks,
+                             const axis_size_t y, const axis_size_t z, ConstraintScore& totalScore) const noexcept {
+            for (size_t i = 0; i < m_WordsPerRow; ++i) {
+                for (uint64_t firstBits = first[i]; firstBits != 0; firstBits &= firstBits - 1) {
+                    const auto x1 = static_cast<axis_size_t>(i * 64 + std::countr_zero(firstBits));
+                    const uint64_t *conflictMask = &conflictMasks[x1 * m_WordsPerRow];
+                    if (!totalScore.recordsViolations()) {
+                        totalScore.addStrictScore(-2 * static_cast<score_t>(Simd::countCommonBits(conflictMask, second, m_WordsPerRow)));
+                        continue;
+                    }
+                    for (size_t j = 0; j < m_WordsPerRow; ++j) {
+                        for (uint64_t conflicts = conflictMask[j] & second[j]; conflicts != 0; conflicts &= conflicts - 1) {
+                            const auto x2 = static_cast<axis_size_t>(j * 64 + std::countr_zero(conflicts));
+                            totalScore.violate(Violation::xyz(x1, y, z, {-1}));
+                            totalScore.violate(Violation::xyz(x2, y, z, {-1}));
                         }
                     }
                 }
             }
+        }
 
-            return totalScore;
+        static void setBit(uint64_t *words, const axis_size_t x) noexcept {
+            words[x / 64] |= static_cast<uint64_t>(1) << (x % 64);
         }
 
-    private:
-        BitMatrix::BitSymmetricalMatrix m_IntersectingShiftsInSameDayMatrix;
+        const size_t m_WordsPerRow;
+        /**
+         * Row x1 has bit x2 set if x2 > x1 and both shifts intersect in the same day.
+         */
+        std::vector<uint64_t> m_SameDayConflictMasks;
         /**
-         * The bit is set if x (in the previous day) intersects y (in the next day).<br>
-         * In other words, x corresponds to the previous day and y corresponds to the next day.<br>
+         * Row x1 has bit x2 set if x1 in the previous day intersects x2 in the next day or vice versa.<br>
          * Single shift's maximum duration limit is 24H.
          */
-        BitMatrix::BitSquareMatrix m_IntersectingShiftsInAdjacentDaysMatrix;
+        std::vector<uint64_t> m_AdjacentDayConflictMasks;
+        std::vector<uint64_t> m_AssignedShifts; // Per z: shift bitset of the evaluated employee.
     };
 }
 
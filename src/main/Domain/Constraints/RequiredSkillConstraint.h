@@ -5,6 +5,11 @@
 
 #include "Array/BitMatrix.h"
 
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <tuple>
+
 namespace Domain::Constraints {
     class RequiredSkillConstraint final : public DomainConstraint {
     public:
@@ -28,27 +33,150 @@ namespace Domain::Constraints {
 
         ~RequiredSkillConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(
-            const State::DomainState& state) noexcept override {
-            ConstraintScore totalScore;
+        void excludeCandidates(::Moves::AssignmentCandidates& candidates) const noexcept override {
+            for (axis_size_t x = 0; x < candidates.size().width; ++x) {
+                for (axis_size_t y = 0; y < candidates.size().height; ++y) {
+                    for (axis_size_t w = 0; w < candidates.size().concepts; ++w) {
+                        if (!m_AssignableShiftEmployeeSkillMatrix.get(x, y, w)) candidates.exclude(x, y, ::State::ANY, w);
+                    }
+                }
+            }
+        }
 
-            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                for (axis_size_t y = 0; y < state.sizeY(); ++y) {
-                    for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
-                        for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                            if (static_cast<int8_t>(m_AssignableShiftEmployeeSkillMatrix.get(x, y, w)) - static_cast<
-                                int8_t>(state.get(x, y, z, w)) >= 0)
-                                continue;
-                            totalScore.violate(Violation::xyzw(x, y, z, w, {-static_cast<score_t>(1)}));
-                        }
+        /**
+         * Concept map of a compressed state that stores a skill for a shift only if some employee can be assigned to
+         * the shift with it; the other skills of a shift are always violations, so the state never needs them.
+         */
+        [[nodiscard]] static std::shared_ptr<const ::State::ConceptMap> assignableConcepts(const Axes::Axis<Domain::Shift>& xAxis,
+                                                                                          const Axes::Axis<Domain::Employee>& yAxis,
+                                                                                          const Axes::Axis<Domain::Skill>& wAxis) noexcept {
+            std::vector<std::vector<axis_size_t>> validConcepts(xAxis.size());
+            for (axis_size_t x = 0; x < xAxis.size(); ++x) {
+                for (axis_size_t w = 0; w < wAxis.size(); ++w) {
+                    for (axis_size_t y = 0; y < yAxis.size(); ++y) {
+                        if (!isAssignable(xAxis[x], yAxis[y], wAxis[w])) continue;
+                        validConcepts[x].push_back(w);
+                        break;
                     }
                 }
             }
+            return std::make_shared<const ::State::ConceptMap>(validConcepts, wAxis.size());
+        }
+
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            buildNonAssignableMask(state);
+
+            // A violation is an assigned bit that is not assignable, so whole words are checked at once.
+            if (!totalScore.recordsViolations()) {
+                totalScore.addStrictScore(-static_cast<score_t>(m_NonAssignableMask.countCommon(state.getBitArray())));
+                return totalScore;
+            }
+
+            const auto *stateWords = state.getBitArray().getUnderlyingImplementation();
+            const auto *maskWords = m_NonAssignableMask.getUnderlyingImplementation();
+            for (BitArray::array_size_t i = 0; i < m_NonAssignableMask.wordCount(); ++i) {
+                auto bits = stateWords[i] & maskWords[i];
+                if (bits == 0) [[likely]] continue;
+                for (; bits != 0; bits &= bits - 1) {
+                    const auto index = static_cast<state_size_t>(i) * BitArray::Word::length + std::countr_zero(bits);
+                    totalScore.violate(Violation::xyzw(::State::Location::at(index, state.size()), {-static_cast<score_t>(1)}));
+                }
+            }
 
             return totalScore;
         }
 
+        void resetDelta(const State::DomainState& state) noexcept override {
+            m_CommittedScore = evaluate(state, EvaluationMode::FULL);
+            m_HasStagedScore = false;
+        }
+
+        [[nodiscard]] ConstraintScore evaluateDelta(const State::DomainState& state,
+                                                    const std::vector<::State::Location>& flippedLocations,
+                                                    const EvaluationMode mode) noexcept override {
+            // Only flips of non-assignable cells change the score: set bit adds a violation, cleared bit removes one.
+            m_AddedViolations.clear();
+            m_RemovedViolations.clear();
+            for (const auto& location : flippedLocations) {
+                if (m_AssignableShiftEmployeeSkillMatrix.get(location.x, location.y, location.w)) continue;
+                if (state.get(location)) m_AddedViolations.push_back(location);
+                else m_RemovedViolations.push_back(location);
+            }
+
+            if (mode == EvaluationMode::SCORE_ONLY) {
+                ConstraintScore totalScore(mode);
+                totalScore += m_CommittedScore.score();
+                totalScore.addStrictScore(static_cast<score_t>(m_RemovedViolations.size()) - static_cast<score_t>(m_AddedViolations.size()));
+                m_StagedScore = totalScore;
+                m_HasStagedScore = true;
+                return totalScore;
+            }
+
+            if (!m_CommittedScore.recordsViolations()) {
+                m_StagedScore = evaluate(state, mode);
+                m_HasStagedScore = true;
+                return m_StagedScore;
+            }
+
+            m_HasStagedScore = !m_AddedViolations.empty() || !m_RemovedViolations.empty();
+            if (!m_HasStagedScore) return m_CommittedScore;
+
+            // Committed violations are ordered by state index; merge the changes in while keeping that order.
+            const auto less = [&state](const ::State::Location& a, const ::State::Location& b) {
+                return a.index(state.size()) < b.index(state.size());
+            };
+            std::ranges::sort(m_AddedViolations, less);
+            std::ranges::sort(m_RemovedViolations, less);
+
+            ConstraintScore totalScore(mode);
+            const auto& committedViolations = m_CommittedScore.violations();
+            auto committed = committedViolations.begin();
+            auto removed = m_RemovedViolations.begin();
+            for (const auto& added : m_AddedViolations) {
+                for (; committed != committedViolations.end() && less(*committed, added); ++committed) {
+                    if (removed != m_RemovedViolations.end() && *removed == *committed) { ++removed; continue; }
+                    totalScore.violate(Violation(*committed));
+                }
+                totalScore.violate(Violation::xyzw(added, {-static_cast<score_t>(1)}));
+            }
+            for (; committed != committedViolations.end(); ++committed) {
+                if (removed != m_RemovedViolations.end() && *removed == *committed) { ++removed; continue; }
+                totalScore.violate(Violation(*committed));
+            }
+
+            m_StagedScore = totalScore;
+            return totalScore;
+        }
+
+        void commitDelta() noexcept override {
+            if (m_HasStagedScore) m_CommittedScore = std::move(m_StagedScore);
+            m_HasStagedScore = false;
+        }
+
+        void rollbackDelta() noexcept override { m_HasStagedScore = false; }
+
     protected:
+        /**
+         * Expands the (x, y, w) assignable matrix into a mask of non-assignable cells with the same layout as the state.
+         * Built on the first evaluation and rebuilt whenever a state of another size, layout or concept map is evaluated.
+         */
+        void buildNonAssignableMask(const State::DomainState& state) noexcept {
+            if (m_MaskSize == state.size()) [[likely]] return;
+            m_MaskSize = state.size();
+            m_NonAssignableMask = BitArray::BitArray(state.flatSize());
+            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                for (axis_size_t y = 0; y < state.sizeY(); ++y) {
+                    for (axis_size_t w = 0; w < state.sizeW(); ++w) {
+                        if (m_AssignableShiftEmployeeSkillMatrix.get(x, y, w) || !state.hasConcept(x, w)) continue;
+                        for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
+                            m_NonAssignableMask.set(state.size().index(x, y, z, w));
+                        }
+                    }
+                }
+            }
+        }
+
         static bool isAssignable(const Domain::Shift& shift, const Domain::Employee& employee,
                                  const Domain::Skill& skill) noexcept {
             if (!shift.requiresSkill()) [[unlikely]] return true;
@@ -98,6 +226,12 @@ namespace Domain::Constraints {
 
     private:
         BitMatrix::BitMatrix3D m_AssignableShiftEmployeeSkillMatrix;
+        BitArray::BitArray m_NonAssignableMask{0}; // Non-assignable cells expanded over Z in the state layout.
+        ::State::Size m_MaskSize{0, 0, 0, 0}; // Size of the state `m_NonAssignableMask` was built for.
+
+        ConstraintScore m_CommittedScore, m_StagedScore;
+        bool m_HasStagedScore = false;
+        std::vector<::State::Location> m_AddedViolations, m_RemovedViolations;
     };
 }
 
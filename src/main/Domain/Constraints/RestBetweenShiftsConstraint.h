@@ -73,12 +73,39 @@ namespace Domain::Constraints {
 
         ~RestBetweenShiftsConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state) noexcept override {
-            ConstraintScore totalScore;
-            for (axis_size_t y = 0; y < state.sizeY(); ++y) {
-                axis_size_t z = 0;
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            for (axis_size_t y = 0; y < state.sizeY(); ++y) evaluateEmployee(state, y, totalScore);
 
-                // Check same-day intersections for z = 0
+            return totalScore;
+        }
+
+        [[nodiscard]] uint8_t partitionAxis() const noexcept override { return ::State::Area::Y; }
+
+        [[nodiscard]] ConstraintScore evaluatePartition(const State::DomainState& state, const axis_size_t y,
+                                                        const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
+            evaluateEmployee(state, y, totalScore);
+            return totalScore;
+        }
+
+    private:
+        void evaluateEmployee(const State::DomainState& state, const axis_size_t y, ConstraintScore& totalScore) const noexcept {
+            axis_size_t z = 0;
+
+            // Check same-day intersections for z = 0
+            for (axis_size_t x1 = 0; x1 < state.sizeX() - 1; ++x1) {
+                if (!state.get(x1, y, z)) continue; // not assigned
+                for (axis_size_t x2 = x1 + 1; x2 < state.sizeX(); ++x2) {
+                    if (!state.get(x2, y, z) || !m_IntersectingShiftsInSameDayMatrix.get(x1, x2))
+                        continue; // not assigned or not intersecting
+                    totalScore.violate(Violation::xyz(x1, y, z, {-1}));
+                    totalScore.violate(Violation::xyz(x2, y, z, {-1}));
+                }
+            }
+
+            for (z = 1; z < state.sizeZ(); ++z) {
+                // Check same-day intersections for z > 0
                 for (axis_size_t x1 = 0; x1 < state.sizeX() - 1; ++x1) {
                     if (!state.get(x1, y, z)) continue; // not assigned
                     for (axis_size_t x2 = x1 + 1; x2 < state.sizeX(); ++x2) {
@@ -89,41 +116,25 @@ namespace Domain::Constraints {
                     }
                 }
 
-                for (z = 1; z < state.sizeZ(); ++z) {
-                    // Check same-day intersections for z > 0
-                    for (axis_size_t x1 = 0; x1 < state.sizeX() - 1; ++x1) {
-                        if (!state.get(x1, y, z)) continue; // not assigned
-                        for (axis_size_t x2 = x1 + 1; x2 < state.sizeX(); ++x2) {
-                            if (!state.get(x2, y, z) || !m_IntersectingShiftsInSameDayMatrix.get(x1, x2))
-                                continue; // not assigned or not intersecting
-                            totalScore.violate(Violation::xyz(x1, y, z, {-1}));
-                            totalScore.violate(Violation::xyz(x2, y, z, {-1}));
-                        }
-                    }
-
-                    // Check previous and next day intersections
-                    for (axis_size_t x1 = 0; x1 < state.sizeX(); ++x1) {
-                        for (int32_t i = 0; i < m_MaxOffsetDays; ++i) {
-                            const int32_t offsetDay = i + 1;
-                            if (offsetDay > z) continue;
-                            if (state.get(x1, y, z - offsetDay)) {
-                                for (axis_size_t x2 = 0; x2 < state.sizeX(); ++x2) {
-                                    if (!state.get(x2, y, z) || (!m_IntersectingShiftsInAdjacentDaysMatrices[i].
-                                        get(x1, x2) && !m_IntersectingShiftsInAdjacentDaysMatrices[i].get(x2, x1)))
-                                        continue; // not assigned or not intersecting
-                                    totalScore.violate(Violation::xyz(x1, y, z, {-1}));
-                                    totalScore.violate(Violation::xyz(x2, y, z, {-1}));
-                                }
+                // Check previous and next day intersections
+                for (axis_size_t x1 = 0; x1 < state.sizeX(); ++x1) {
+                    for (int32_t i = 0; i < m_MaxOffsetDays; ++i) {
+                        const int32_t offsetDay = i + 1;
+                        if (offsetDay > z) continue;
+                        if (state.get(x1, y, z - offsetDay)) {
+                            for (axis_size_t x2 = 0; x2 < state.sizeX(); ++x2) {
+                                if (!state.get(x2, y, z) || (!m_IntersectingShiftsInAdjacentDaysMatrices[i].
+                                    get(x1, x2) && !m_IntersectingShiftsInAdjacentDaysMatrices[i].get(x2, x1)))
+                                    continue; // not assigned or not intersecting
+                                totalScore.violate(Violation::xyz(x1, y, z, {-1}));
+                                totalScore.violate(Violation::xyz(x2, y, z, {-1}));
                             }
                         }
                     }
                 }
             }
-
-            return totalScore;
         }
 
-    private:
         int32_t m_MaxOffsetDays;
         BitMatrix::BitSymmetricalMatrix m_IntersectingShiftsInSameDayMatrix;
         /**
@@ -37,33 +37,11 @@ namespace Domain::Constraints {
 
         ~ShiftCoverageConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state) noexcept override {
-            ConstraintScore totalScore;
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
             for (axis_size_t x = 0; x < state.sizeX(); ++x) {
                 for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
-                    const auto& [slotCount, requiredSlotCount, durationInMinutes] = m_CoverageData[x * state.sizeZ() +
-                        z];
-
-                    score_t absDayScore = 0;
-
-                    axis_size_t assignedEmployeeCount = 0;
-                    for (axis_size_t y = 0; y < state.sizeY(); ++y) {
-                        assignedEmployeeCount += static_cast<axis_size_t>(state.get(x, y, z));
-                    }
-
-                    if (slotCount != 0 && assignedEmployeeCount > slotCount) {
-                        absDayScore += static_cast<score_t>(assignedEmployeeCount - static_cast<axis_size_t>(slotCount))
-                            *
-                            durationInMinutes;
-                    }
-
-                    if (assignedEmployeeCount < requiredSlotCount) {
-                        absDayScore += static_cast<score_t>(static_cast<axis_size_t>(requiredSlotCount) -
-                                assignedEmployeeCount)
-                            * durationInMinutes;
-                    }
-
-                    const score_t dayScore = -(absDayScore * absDayScore);
+                    const score_t dayScore = slotScore(x * state.sizeZ() + z, state.countXZ(x, z));
 
                     totalScore.violate(Violation::xz(x, z, {0, dayScore, 0}));
                 }
@@ -146,6 +124,64 @@ namespace Domain::Constraints {
             return totalScore;
         }
 
+        void resetDelta(const State::DomainState& state) noexcept override {
+            m_ZSize = state.sizeZ();
+            m_SlotScore.assign(state.sizeX() * state.sizeZ(), 0);
+            m_CommittedScore = 0;
+            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
+                    const size_t slot = x * m_ZSize + z;
+                    m_SlotScore[slot] = slotScore(slot, state.countXZ(x, z));
+                    m_CommittedScore += m_SlotScore[slot];
+                }
+            }
+            m_StagedScore = m_CommittedScore;
+            m_StagedChanges.clear();
+        }
+
+        [[nodiscard]] ConstraintScore evaluateDelta(const State::DomainState& state,
+                                                    const std::vector<::State::Location>& flippedLocations,
+                                                    const EvaluationMode mode) noexcept override {
+            // Slot scores are updated in place from the occupancy of the state; the previous ones are kept so that
+            // they can be rolled back.
+            m_StagedChanges.clear();
+            m_StagedScore = m_CommittedScore;
+            for (const auto& location : flippedLocations) {
+                const size_t slot = location.x * m_ZSize + location.z;
+                const score_t score = slotScore(slot, state.countXZ(location.x, location.z));
+                if (score == m_SlotScore[slot]) continue;
+                m_StagedChanges.emplace_back(slot, m_SlotScore[slot]);
+                m_StagedScore += score - m_SlotScore[slot];
+                m_SlotScore[slot] = score;
+            }
+
+            ConstraintScore totalScore(mode);
+            if (!totalScore.recordsViolations()) {
+                totalScore.addHardScore(m_StagedScore);
+                return totalScore;
+            }
+            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
+                    totalScore.violate(Violation::xz(x, z, {0, m_SlotScore[x * m_ZSize + z], 0}));
+                }
+            }
+            return totalScore;
+        }
+
+        void commitDelta() noexcept override {
+            m_CommittedScore = m_StagedScore;
+            m_StagedChanges.clear();
+        }
+
+        void rollbackDelta() noexcept override {
+            // In reverse, so that the score before the first change of a slot is restored last
+            for (auto change = m_StagedChanges.rbegin(); change != m_StagedChanges.rend(); ++change) {
+                m_SlotScore[change->first] = change->second;
+            }
+            m_StagedScore = m_CommittedScore;
+            m_StagedChanges.clear();
+        }
+
     private:
         struct CoverageData {
             uint8_t slotCount;
@@ -161,6 +197,34 @@ namespace Domain::Constraints {
         std::vector<CoverageData> m_CoverageData;
         const int64_t m_WorkloadDurationInRange;
 
+        axis_size_t m_ZSize{};
+        std::vector<score_t> m_SlotScore; // Per (x, z): committed or staged slot score.
+        std::vector<std::pair<size_t, score_t>> m_StagedChanges; // Slot and its score before the staged change.
+        score_t m_CommittedScore{}, m_StagedScore{};
+
+        /**
+         * Squared deviation of the assigned employee count from the slot bounds of a (shift, day) slot.
+         */
+        [[nodiscard]] score_t slotScore(const size_t slot, const axis_size_t assignedEmployeeCount) const noexcept {
+            const auto& [slotCount, requiredSlotCount, durationInMinutes] = m_CoverageData[slot];
+
+            score_t absDayScore = 0;
+
+            if (slotCount != 0 && assignedEmployeeCount > slotCount) {
+                absDayScore += static_cast<score_t>(assignedEmployeeCount - static_cast<axis_size_t>(slotCount))
+                    *
+                    durationInMinutes;
+            }
+
+            if (assignedEmployeeCount < requiredSlotCount) {
+                absDayScore += static_cast<score_t>(static_cast<axis_size_t>(requiredSlotCount) -
+                        assignedEmployeeCount)
+                    * durationInMinutes;
+            }
+
+            return -(absDayScore * absDayScore);
+        }
+
         EmployeeAssignmentDuration employeeAssignmentDuration(const State::DomainState& st, const axis_size_t y) const noexcept {
             const auto& employee = st.y()[y];
             const auto& totalChangeEvent = employee.totalChangeEvent();
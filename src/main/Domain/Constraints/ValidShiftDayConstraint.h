@@ -6,6 +6,8 @@
 
 #include "Array/BitMatrix.h"
 
+#include <vector>
+
 namespace Domain::Constraints {
     class ValidShiftDayConstraint final : public DomainConstraint {
     public:
@@ -34,9 +36,16 @@ namespace Domain::Constraints {
 
         ~ValidShiftDayConstraint() noexcept override = default;
 
-        [[nodiscard]] ConstraintScore evaluate(
-            const State::DomainState& state) noexcept override {
-            ConstraintScore totalScore;
+        void excludeCandidates(::Moves::AssignmentCandidates& candidates) const noexcept override {
+            for (axis_size_t x = 0; x < candidates.size().width; ++x) {
+                for (axis_size_t z = 0; z < candidates.size().depth; ++z) {
+                    if (m_ShiftAndDayConflictMatrix.get(x, z)) candidates.exclude(x, ::State::ANY, z, ::State::ANY);
+                }
+            }
+        }
+
+        [[nodiscard]] ConstraintScore evaluate(const State::DomainState& state, const EvaluationMode mode) noexcept override {
+            ConstraintScore totalScore(mode);
             for (axis_size_t x = 0; x < state.sizeX(); ++x) {
                 for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
                     if (!state.getXZ(x, z) || !m_ShiftAndDayConflictMatrix.get(x, z)) continue;
@@ -47,8 +56,88 @@ namespace Domain::Constraints {
             return totalScore;
         }
 
+        void resetDelta(const State::DomainState& state) noexcept override {
+            m_ZSize = state.sizeZ();
+            m_AssignmentCount.assign(state.sizeX() * state.sizeZ(), 0);
+            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                for (axis_size_t y = 0; y < state.sizeY(); ++y) {
+                    for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
+                        for (axis_size_t w = 0; w < state.sizeW(); ++w) {
+                            m_AssignmentCount[x * m_ZSize + z] += state.get(x, y, z, w);
+                        }
+                    }
+                }
+            }
+            m_CommittedScore = evaluate(state, EvaluationMode::FULL);
+            m_StagedChanges.clear();
+        }
+
+        [[nodiscard]] ConstraintScore evaluateDelta(const State::DomainState& state,
+                                                    const std::vector<::State::Location>& flippedLocations,
+                                                    const EvaluationMode mode) noexcept override {
+            // Counts are updated in place; staged changes are kept so that they can be rolled back.
+            m_StagedChanges.clear();
+            m_HasStagedScore = false;
+            bool violationsChanged = false;
+            score_t violationCountChange = 0;
+            for (const auto& location : flippedLocations) {
+                if (!m_ShiftAndDayConflictMatrix.get(location.x, location.z)) continue;
+                const size_t index = location.x * m_ZSize + location.z;
+                const int32_t change = state.get(location) ? 1 : -1;
+                const bool wasViolated = m_AssignmentCount[index] > 0;
+                m_AssignmentCount[index] += change;
+                m_StagedChanges.emplace_back(index, change);
+                if (wasViolated == (m_AssignmentCount[index] > 0)) continue;
+                violationsChanged = true;
+                violationCountChange += wasViolated ? -1 : 1;
+            }
+
+            // Every violated slot costs one strict point, so the score follows from the slots that crossed zero;
+            // violations are only listed again (by a full scan) in FULL mode.
+            if (mode == EvaluationMode::SCORE_ONLY) {
+                ConstraintScore totalScore(mode);
+                totalScore += m_CommittedScore.score();
+                totalScore.addStrictScore(-violationCountChange);
+                m_StagedScore = totalScore;
+                m_HasStagedScore = true;
+                return totalScore;
+            }
+
+            if (!violationsChanged && m_CommittedScore.recordsViolations())
+                return m_CommittedScore;
+
+            ConstraintScore totalScore(mode);
+            for (axis_size_t x = 0; x < state.sizeX(); ++x) {
+                for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
+                    if (m_AssignmentCount[x * m_ZSize + z] == 0 || !m_ShiftAndDayConflictMatrix.get(x, z)) continue;
+                    totalScore.violate(Violation::xz(x, z, {-1}));
+                }
+            }
+            m_StagedScore = totalScore;
+            m_HasStagedScore = true;
+            return totalScore;
+        }
+
+        void commitDelta() noexcept override {
+            if (m_HasStagedScore) m_CommittedScore = std::move(m_StagedScore);
+            m_HasStagedScore = false;
+            m_StagedChanges.clear();
+        }
+
+        void rollbackDelta() noexcept override {
+            for (const auto& [index, change] : m_StagedChanges) m_AssignmentCount[index] -= change;
+            m_HasStagedScore = false;
+            m_StagedChanges.clear();
+        }
+
     private:
         BitMatrix::BitMatrix m_ShiftAndDayConflictMatrix;
+
+        axis_size_t m_ZSize{};
+        std::vector<int32_t> m_AssignmentCount;
+        std::vector<std::pair<size_t, int32_t>> m_StagedChanges;
+        ConstraintScore m_CommittedScore, m_StagedScore;
+        bool m_HasStagedScore = false;
     };
 }
 
@@ -32,6 +32,11 @@ namespace Domain::Moves {
         void revert(State::DomainState& state) const noexcept override {
             state.assign(m_X, m_Y, m_Z, m_W, m_PrevValue);
         }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            locations.emplace_back(m_X, m_Y, m_Z, m_W);
+            return true;
+        }
     private:
         inline static Random::RandomGenerator& m_Random = Random::generator();
         uint8_t m_PrevValue{};
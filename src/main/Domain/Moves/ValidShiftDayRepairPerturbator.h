@@ -7,7 +7,7 @@
 namespace Domain::Moves {
     class ValidShiftDayRepairPerturbator final : public DomainAutonomousPerturbator {
     public:
-        explicit ValidShiftDayRepairPerturbator(const axis_size_t yAxisSize, const axis_size_t wAxisSize) noexcept : m_PrevValue(BitArray::BitArray(yAxisSize * wAxisSize)) {}
+        explicit ValidShiftDayRepairPerturbator(const axis_size_t yAxisSize, const axis_size_t wAxisSize) noexcept : m_PrevValue(BitArray::BitArray(yAxisSize * wAxisSize)), m_YSize(yAxisSize), m_WSize(wAxisSize) {}
 
         [[nodiscard]] ValidShiftDayRepairPerturbator *clone() const noexcept override {
             return new ValidShiftDayRepairPerturbator(*this);
@@ -38,8 +38,18 @@ namespace Domain::Moves {
                 }
             }
         }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            for (axis_size_t y = 0; y < m_YSize; ++y) {
+                for (axis_size_t w = 0; w < m_WSize; ++w) {
+                    if (m_PrevValue.get(y * m_WSize + w)) locations.emplace_back(m_X, y, m_Z, w);
+                }
+            }
+            return true;
+        }
     private:
         BitArray::BitArray m_PrevValue;
+        axis_size_t m_YSize, m_WSize;
         axis_size_t m_X{}, m_Z{};
     };
 }
@@ -1,9 +1,11 @@
 #ifndef HEURISTICPROVIDER_H
 #define HEURISTICPROVIDER_H
 
+#include "Moves/AssignmentCandidates.h"
 #include "Moves/Perturbator.h"
 #include "Moves/AutonomousPerturbator.h"
 #include "Moves/PerturbatorChain.h"
+#include "Moves/PerturbatorPool.h"
 #include "Search/Evaluation.h"
 #include "State/State.h"
 
@@ -46,17 +48,20 @@ namespace Heuristics {
     public:
         explicit HeuristicProvider(const ::State::State<X, Y, Z, W> *initialState, const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints) noexcept :
             m_ConstraintCount(constraints.size()),
+            m_AssignmentCandidates(initialState->size()),
             m_TransformerModel(HYPERHEURISTICS_INPUT_DIM, HYPERHEURISTICS_D_MODEL, HYPERHEURISTICS_N_HEAD,
                                HYPERHEURISTICS_NUM_LAYERS, HYPERHEURISTICS_HEURISTIC_COUNT) {
-            m_GeneratedPerturbators.shrink_to_fit();
+            for (const auto *constraint : constraints) constraint->excludeCandidates(m_AssignmentCandidates);
+            m_AssignmentCandidates.build();
 
             m_AvailablePerturbators = {
-                new RandomAssignmentTogglePerturbator<X, Y, Z, W>(),
+                new RandomAssignmentTogglePerturbator<X, Y, Z, W>(&m_AssignmentCandidates),
                 new VerticalExchangePerturbator<X, Y, Z, W>(),
                 new HorizontalExchangePerturbator<X, Y, Z, W>(),
                 new ShiftByZPerturbator<X, Y, Z, W>(),
-                new RankedIntersectionTogglePerturbator<X, Y, Z, W>(constraints),
+                new RankedIntersectionTogglePerturbator<X, Y, Z, W>(constraints, &m_AssignmentCandidates),
             };
+            for (const auto *perturbator : m_AvailablePerturbators) m_AvailableKinds.push_back(m_Pool.kindOf(perturbator));
 
             torch::manual_seed(42);
         }
@@ -68,98 +73,102 @@ namespace Heuristics {
 
         Perturbator<X, Y, Z, W> *operator[](const size_t index) const noexcept { return m_AvailablePerturbators[index]; }
 
+        [[nodiscard]] const AssignmentCandidates& assignmentCandidates() const noexcept { return m_AssignmentCandidates; }
+
         PerturbatorChain<X, Y, Z, W> predictPerturbators(const Evaluation::Evaluator<X, Y, Z, W>& evaluator,
                                                          const ::State::State<X, Y, Z, W>& state) noexcept {
-            m_GeneratedPerturbators.clear();
-            if (evaluator.m_TotalConstraintViolationCount == 0) return PerturbatorChain(m_GeneratedPerturbators);
+            PerturbatorChain<X, Y, Z, W> chain(m_Pool);
+            evaluator.materializeViolations(state);
+            if (evaluator.m_TotalConstraintViolationCount == 0) return chain;
 
             auto tensor = createInputTensor(evaluator);
             tensor = m_TransformerModel->forward(tensor);
             auto perturb = createHeuristicFromTensor(tensor, state.size());
-            if (perturb == nullptr) return PerturbatorChain(m_GeneratedPerturbators);
+            if (perturb == nullptr) return chain;
 
             perturb->configure(state);
             if (perturb->isIdentity()) {
                 delete perturb;
-                return PerturbatorChain(m_GeneratedPerturbators);
+                return chain;
             }
 
-            m_GeneratedPerturbators.reserve(1);
-            m_GeneratedPerturbators.emplace_back(perturb);
+            chain.push({perturb, PerturbatorPool<X, Y, Z, W>::UNPOOLED});
 
-            return PerturbatorChain(m_GeneratedPerturbators);
+            return chain;
         }
 
         [[nodiscard]] PerturbatorChain<X, Y, Z, W> generateRepairPerturbators(
             const Evaluation::Evaluator<X, Y, Z, W>& evaluator,
             const ::State::State<X, Y, Z, W>& state) noexcept {
-            m_GeneratedPerturbators.clear();
-            m_GeneratedPerturbators.reserve(evaluator.m_ViolatedConstraintCount);
+            PerturbatorChain<X, Y, Z, W> chain(m_Pool);
+            evaluator.materializeViolations(state);
             for (size_t i = 0; i < evaluator.m_ConstraintScores.size(); ++i) {
                 const auto& constraint = evaluator.m_Constraints[i];
                 const auto& constraintScore = evaluator.m_ConstraintScores[i];
                 if (constraint->getRepairPerturbators().size() > 0) [[likely]] {
                     for (const auto& repairPerturbator : constraint->getRepairPerturbators()) {
+                        const uint32_t kind = m_Pool.kindOf(repairPerturbator);
                         for (const auto& violation : constraintScore.violations()) {
-                            AutonomousPerturbator<X, Y, Z, W> *perturb = repairPerturbator->clone();
+                            AutonomousPerturbator<X, Y, Z, W> *perturb = m_Pool.acquire(kind);
                             perturb->configure(&violation, state);
                             if (perturb->isIdentity()) {
-                                delete perturb;
+                                m_Pool.release({perturb, kind});
                                 continue;
                             }
-                            m_GeneratedPerturbators.emplace_back(perturb);
+                            chain.push({perturb, kind});
                         }
                     }
                 }
             }
-            return PerturbatorChain(m_GeneratedPerturbators);
+            return chain;
         }
 
         [[nodiscard]] PerturbatorChain<X, Y, Z, W> generateSearchPerturbators(
             const Evaluation::Evaluator<X, Y, Z, W>& evaluator,
             const ::State::State<X, Y, Z, W>& state) noexcept {
-            m_GeneratedPerturbators.clear();
-            
+            PerturbatorChain<X, Y, Z, W> chain(m_Pool);
+
             size_t count = m_Random.randomInt(1, 2);
-            m_GeneratedPerturbators.reserve(count);
 
             // Use simpler heuristics more frequently (80% of time)
             if (m_Random.randomInt(0, 10) > 2) {
                 // Fast random perturbations (no constraint analysis needed)
-                const AutonomousPerturbator<X, Y, Z, W> *perturbTemplate = m_AvailablePerturbators[0];
+                const uint32_t kind = m_AvailableKinds[0];
                 for (size_t i = 0; i < count; ++i) {
-                    AutonomousPerturbator<X, Y, Z, W> *perturb = perturbTemplate->clone();
+                    AutonomousPerturbator<X, Y, Z, W> *perturb = m_Pool.acquire(kind);
                     perturb->configure(nullptr, state);
                     if (!perturb->isIdentity()) {
-                        m_GeneratedPerturbators.emplace_back(perturb);
+                        chain.push({perturb, kind});
                     } else {
-                        delete perturb;
+                        m_Pool.release({perturb, kind});
                     }
                 }
             } else {
                 // Smarter heuristics (20% of time)
-                for (const auto* perturbTemplate : m_AvailablePerturbators) {
-                    if (m_GeneratedPerturbators.size() >= count) break;
-                    auto* perturb = perturbTemplate->clone();
+                for (const uint32_t kind : m_AvailableKinds) {
+                    if (chain.size() >= count) break;
+                    auto* perturb = m_Pool.acquire(kind);
                     if (perturb->configureIfApplicable(evaluator, state) && !perturb->isIdentity()) {
-                        m_GeneratedPerturbators.emplace_back(perturb);
+                        chain.push({perturb, kind});
                     } else {
-                        delete perturb;
+                        m_Pool.release({perturb, kind});
                     }
                 }
             }
 
-            return PerturbatorChain(m_GeneratedPerturbators);
+            return chain;
         }
 
     private:
         inline static Random::RandomGenerator& m_Random = Random::generator();
 
         const size_t m_ConstraintCount;
+        AssignmentCandidates m_AssignmentCandidates; // Shared by the perturbators that sample assignments.
         std::vector<AutonomousPerturbator<X, Y, Z, W> *> m_AvailablePerturbators;
         HyperHeuristics::TransformerModel m_TransformerModel;
 
-        std::vector<Perturbator<X, Y, Z, W> *> m_GeneratedPerturbators {};
+        PerturbatorPool<X, Y, Z, W> m_Pool;
+        std::vector<uint32_t> m_AvailableKinds; // Pool kind of every available perturbator.
 
         [[nodiscard]] torch::Tensor createInputTensor(const Evaluation::Evaluator<X, Y, Z, W>& evaluator) noexcept {
             constexpr int batchSize = 1;
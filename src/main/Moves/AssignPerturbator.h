@@ -26,6 +26,11 @@ namespace Moves {
             state.assign(m_Location, m_PrevValue);
         }
 
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            locations.push_back(m_Location);
+            return true;
+        }
+
     protected:
         ::State::Location m_Location;
         uint8_t m_PrevValue{};
@@ -0,0 +1,156 @@
+#ifndef ASSIGNMENTCANDIDATES_H
+#define ASSIGNMENTCANDIDATES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "State/Size.h"
+#include "State/Location.h"
+#include "State/SetLocations.h"
+
+#include "Array/BitArray.h"
+
+namespace Moves {
+    /**
+     * Assignments that are worth sampling: every (x, y, z, w) except the ones some constraint always rejects (see
+     * `Constraint::excludeCandidates`) and the concepts a compressed state doesn't store.<br>
+     * After `build`, the eligible (y, w) pairs of every (x, z) and the eligible (x, z, w) cells of every y, grouped by
+     * z, are kept as contiguous lists, so moves draw from them instead of from the whole box, most of which is rejected
+     * outright.
+     */
+    class AssignmentCandidates {
+        using axis_size_t = ::State::axis_size_t;
+    public:
+        struct Pair {
+            axis_size_t y, w;
+        };
+
+        struct Cell {
+            axis_size_t x, z, w;
+        };
+
+        explicit AssignmentCandidates(const ::State::Size& size) noexcept :
+            m_Size(size),
+            m_Eligible(static_cast<BitArray::array_size_t>(size.width) * size.height * size.depth * size.concepts) {
+            m_Eligible.setAll();
+            if (size.conceptMap == nullptr) return;
+            for (axis_size_t x = 0; x < size.width; ++x) {
+                for (axis_size_t w = 0; w < size.concepts; ++w) {
+                    if (!size.conceptMap->isValid(x, w)) exclude(x, ::State::ANY, ::State::ANY, w);
+                }
+            }
+        }
+
+        [[nodiscard]] const ::State::Size& size() const noexcept { return m_Size; }
+
+        /**
+         * Marks the matching assignments as not eligible; every coordinate is either fixed or `ANY`.
+         * Takes effect on the next `build`.
+         */
+        void exclude(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) noexcept {
+            const auto [x0, x1] = range(x, m_Size.width);
+            const auto [y0, y1] = range(y, m_Size.height);
+            const auto [z0, z1] = range(z, m_Size.depth);
+            const auto [w0, w1] = range(w, m_Size.concepts);
+            for (axis_size_t ix = x0; ix < x1; ++ix)
+                for (axis_size_t iy = y0; iy < y1; ++iy)
+                    for (axis_size_t iz = z0; iz < z1; ++iz)
+                        for (axis_size_t iw = w0; iw < w1; ++iw) m_Eligible.clear(index(ix, iy, iz, iw));
+        }
+
+        /**
+         * Rebuilds the candidate lists from the eligibility mask.
+         */
+        void build() noexcept {
+            m_PairOffsets.assign(static_cast<size_t>(m_Size.width) * m_Size.depth + 1, 0);
+            m_CellOffsets.assign(static_cast<size_t>(m_Size.height) * m_Size.depth + 1, 0);
+            m_Pairs.clear();
+            m_Cells.clear();
+            for (axis_size_t x = 0; x < m_Size.width; ++x) {
+                for (axis_size_t z = 0; z < m_Size.depth; ++z) {
+                    for (axis_size_t y = 0; y < m_Size.height; ++y)
+                        for (axis_size_t w = 0; w < m_Size.concepts; ++w)
+                            if (isEligible(x, y, z, w)) m_Pairs.push_back(Pair {y, w});
+                    m_PairOffsets[x * m_Size.depth + z + 1] = m_Pairs.size();
+                }
+            }
+            for (axis_size_t y = 0; y < m_Size.height; ++y) {
+                for (axis_size_t z = 0; z < m_Size.depth; ++z) {
+                    for (axis_size_t x = 0; x < m_Size.width; ++x)
+                        for (axis_size_t w = 0; w < m_Size.concepts; ++w)
+                            if (isEligible(x, y, z, w)) m_Cells.push_back(Cell {x, z, w});
+                    m_CellOffsets[y * m_Size.depth + z + 1] = m_Cells.size();
+                }
+            }
+        }
+
+        [[nodiscard]] bool isEligible(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) const noexcept {
+            return m_Eligible.get(index(x, y, z, w));
+        }
+
+        [[nodiscard]] bool isEligible(const ::State::Location& location) const noexcept {
+            return isEligible(location.x, location.y, location.z, location.w);
+        }
+
+        /**
+         * @return Eligible (y, w) pairs of (`x`, `z`).
+         */
+        [[nodiscard]] std::span<const Pair> pairs(const axis_size_t x, const axis_size_t z) const noexcept {
+            const size_t i = x * m_Size.depth + z;
+            return {m_Pairs.data() + m_PairOffsets[i], m_Pairs.data() + m_PairOffsets[i + 1]};
+        }
+
+        /**
+         * @return Eligible (x, z, w) cells of `y`.
+         */
+        [[nodiscard]] std::span<const Cell> cells(const axis_size_t y) const noexcept {
+            const size_t i = static_cast<size_t>(y) * m_Size.depth;
+            return {m_Cells.data() + m_CellOffsets[i], m_Cells.data() + m_CellOffsets[i + m_Size.depth]};
+        }
+
+        /**
+         * @return Eligible (x, z, w) cells of (`y`, `z`).
+         */
+        [[nodiscard]] std::span<const Cell> cells(const axis_size_t y, const axis_size_t z) const noexcept {
+            const size_t i = static_cast<size_t>(y) * m_Size.depth + z;
+            return {m_Cells.data() + m_CellOffsets[i], m_Cells.data() + m_CellOffsets[i + 1]};
+        }
+
+        /**
+         * @return Number of eligible assignments.
+         */
+        [[nodiscard]] size_t count() const noexcept { return m_Cells.size(); }
+
+        /**
+         * @return The `i`-th eligible assignment, ordered by y; a uniform `i` below `count()` samples them uniformly.
+         */
+        [[nodiscard]] ::State::Location at(const size_t i) const noexcept {
+            const auto y = static_cast<axis_size_t>((std::ranges::upper_bound(m_CellOffsets, i) - m_CellOffsets.begin() - 1) / m_Size.depth);
+            const auto& [x, z, w] = m_Cells[i];
+            return ::State::Location {x, y, z, w};
+        }
+
+    private:
+        ::State::Size m_Size;
+        BitArray::BitArray m_Eligible; // Per (x, y, z, w), independent of the state layout.
+
+        std::vector<size_t> m_PairOffsets; // Per (x, z), into `m_Pairs`.
+        std::vector<Pair> m_Pairs;
+        std::vector<size_t> m_CellOffsets; // Per (y, z), into `m_Cells`.
+        std::vector<Cell> m_Cells;
+
+        [[nodiscard]] BitArray::array_size_t index(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) const noexcept {
+            return ((static_cast<BitArray::array_size_t>(x) * m_Size.height + y) * m_Size.depth + z) * m_Size.concepts + w;
+        }
+
+        [[nodiscard]] static std::pair<axis_size_t, axis_size_t> range(const axis_size_t coordinate, const axis_size_t extent) noexcept {
+            if (coordinate == ::State::ANY) return {0, extent};
+            return {coordinate, coordinate + 1};
+        }
+    };
+}
+
+#endif //ASSIGNMENTCANDIDATES_H
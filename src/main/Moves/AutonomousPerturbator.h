@@ -93,6 +93,10 @@ namespace Moves {
         void modify(::State::State<X, Y, Z, W>&) noexcept override { }
         void revert(::State::State<X, Y, Z, W>&) const noexcept override { }
 
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>&) const noexcept override {
+            return true;
+        }
+
     private:
         IdentityPerturbator() noexcept = default;
         ~IdentityPerturbator() noexcept override = default;
@@ -0,0 +1,103 @@
+#ifndef FLIPLIST_H
+#define FLIPLIST_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "State/State.h"
+#include "State/Size.h"
+#include "State/Location.h"
+
+#include "Array/BitArray.h"
+
+namespace Moves {
+    /**
+     * Bits to toggle in one word of the flat state.
+     */
+    struct Flip {
+        BitArray::array_size_t word;
+        uint64_t mask;
+    };
+
+    /**
+     * Value-type move: up to `Capacity` words of the flat state with the bits to toggle in each, stored inline.<br>
+     * Applying it is one `State::flipWord` per word, and since toggling is its own inverse, reverting applies it again.
+     * Flips of the same bit cancel out and words left without flips are dropped, so an empty list is an identity move
+     * and the flipped bits are exactly the change set of the move.
+     */
+    template<uint16_t Capacity>
+    class FlipList {
+    public:
+        FlipList() noexcept : m_Size(0, 0, 0, 0) { }
+
+        [[nodiscard]] bool empty() const noexcept { return m_Count == 0; }
+        [[nodiscard]] uint16_t size() const noexcept { return m_Count; }
+        [[nodiscard]] uint16_t remaining() const noexcept { return Capacity - m_Count; }
+
+        [[nodiscard]] const Flip *begin() const noexcept { return m_Flips.data(); }
+        [[nodiscard]] const Flip *end() const noexcept { return m_Flips.data() + m_Count; }
+
+        /**
+         * Empties the list for a state of the given size.
+         */
+        void reset(const ::State::Size& size) noexcept {
+            m_Size = size;
+            m_Count = 0;
+        }
+
+        void clear() noexcept { m_Count = 0; }
+
+        /**
+         * Toggles the bit at `index`.
+         * @return `false` if the list is full and doesn't hold the word of the bit yet; nothing is flipped then.
+         */
+        bool flip(const ::State::state_size_t index) noexcept {
+            const auto word = static_cast<BitArray::array_size_t>(index / BitArray::Word::length);
+            const uint64_t bit = static_cast<uint64_t>(1) << index % BitArray::Word::length;
+            for (uint16_t i = 0; i < m_Count; ++i) {
+                if (m_Flips[i].word != word) continue;
+                m_Flips[i].mask ^= bit;
+                if (m_Flips[i].mask == 0) m_Flips[i] = m_Flips[--m_Count];
+                return true;
+            }
+            if (m_Count == Capacity) return false;
+            m_Flips[m_Count++] = Flip {word, bit};
+            return true;
+        }
+
+        /**
+         * Toggles `location`. Concepts a compressed state doesn't store are skipped, as they are by state writes.
+         * @return `false` if the list is full; see `flip(index)`.
+         */
+        bool flip(const ::State::Location& location) noexcept {
+            if (m_Size.conceptMap != nullptr && !m_Size.conceptMap->isValid(location.x, location.w)) return true;
+            return flip(location.index(m_Size));
+        }
+
+        template<typename X, typename Y, typename Z, typename W>
+        void apply(::State::State<X, Y, Z, W>& state) const noexcept {
+            for (const auto& [word, mask] : *this) state.flipWord(word, mask);
+        }
+
+        /**
+         * Appends every flipped location.
+         */
+        void collectChangedLocations(std::vector<::State::Location>& locations) const noexcept {
+            for (const auto& [word, mask] : *this) {
+                const ::State::state_size_t base = static_cast<::State::state_size_t>(word) * BitArray::Word::length;
+                for (uint64_t remaining = mask; remaining != 0; remaining &= remaining - 1) {
+                    locations.push_back(::State::Location::at(base + std::countr_zero(remaining), m_Size));
+                }
+            }
+        }
+
+    private:
+        ::State::Size m_Size;
+        uint16_t m_Count = 0;
+        std::array<Flip, Capacity> m_Flips {};
+    };
+}
+
+#endif //FLIPLIST_H
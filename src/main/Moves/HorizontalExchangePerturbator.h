@@ -2,15 +2,11 @@
 #define HORIZONTALEXCHANGEPERTURBATOR_H
 
 #include "AutonomousPerturbator.h"
-#include "Structs/HorizontalExchangeAssignLocation.h"
+#include "FlipList.h"
 
 #include "Utils/Random.h"
 
-#include <unordered_map>
-
 namespace Moves {
-    using namespace Structs;
-
     template<typename X, typename Y, typename Z, typename W>
     class HorizontalExchangePerturbator : public AutonomousPerturbator<X, Y, Z, W> {
     public:
@@ -22,6 +18,7 @@ namespace Moves {
         }
 
         void configure(const ::State::State<X, Y, Z, W>& state) noexcept override {
+            m_Flips.reset(state.size());
             if (state.sizeY() < 2 || state.sizeZ() < 1) return;
 
             const axis_size_t y1 = m_Random.randomInt(state.sizeY() - 1);
@@ -30,82 +27,71 @@ namespace Moves {
 
             const axis_size_t randomZ = m_Random.randomInt(state.sizeZ() - 1);
 
-            bool startZInitialized = false;
-            axis_size_t startZ = 0, endZ = 0;
-            std::unordered_map<HorizontalExchangeAssignLocation, uint8_t> locations1 {};
-            locations1.reserve(5);
+            // The block starts at the first Z from `randomZ` on where `y1` is assigned and runs while `y1` is assigned.
+            // Each assignment of the block of `y1` or `y2` is toggled for both, so the two rows swap.
+            bool started = false;
             for (axis_size_t zi = randomZ; zi < state.sizeZ() + randomZ; ++zi) {
                 const axis_size_t z = zi % state.sizeZ();
-                bool assignedAtZ = false;
-                for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                    for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                        if (state.get(x, y1, z, w)) {
-                            assignedAtZ = true;
-                            if (!startZInitialized) {
-                                startZInitialized = true;
-                                startZ = z;
-                            }
-                            locations1.emplace(HorizontalExchangeAssignLocation{x, z, w}, 1);
-                            break;
-                        }
-                    }
-                }
-                if (startZInitialized && !assignedAtZ) {
-                    endZ = z;
-                    break;
-                }
-            }
-            std::unordered_map<HorizontalExchangeAssignLocation, uint8_t> locations2 {};
-            locations2.reserve(endZ >= startZ ? endZ - startZ : state.sizeZ() - startZ + endZ);
-            for (axis_size_t z = startZ; z < endZ; ++z) {
-                for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                    for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                        if (state.get(x, y2, z, w)) {
-                            locations2.emplace(HorizontalExchangeAssignLocation{x, z, w}, 1);
-                            break;
-                        }
-                    }
-                }
-            }
-
-            m_Y1 = y1;
-            m_Y2 = y2;
-            m_LocationXors = std::move(locations1);
-            for (const auto& entry : locations2) {
-                auto loc1 = m_LocationXors.find(entry.first);
-                if (loc1 != m_LocationXors.end()) {
-                    loc1->second ^= entry.second;
-                } else {
-                    m_LocationXors.emplace(entry.first, entry.second);
+                if (!hasAssignment(state, y1, z)) {
+                    if (started) break;
+                    continue;
                 }
+                // Each toggled X takes up to two new words; stop early rather than drop half a day
+                if (m_Flips.remaining() < 2 * (assignedXCount(state, y1, z) + assignedXCount(state, y2, z))) break;
+                started = true;
+                exchange(state, y1, y2, y1, z);
+                exchange(state, y1, y2, y2, z);
             }
         }
 
-        [[nodiscard]] bool isIdentity() const noexcept override {
-            return m_Y1 == m_Y2 || m_LocationXors.empty();
-        }
+        [[nodiscard]] bool isIdentity() const noexcept override { return m_Flips.empty(); }
 
-        void modify(::State::State<X, Y, Z, W>& state) noexcept override {
-            apply(state);
-        }
+        void modify(::State::State<X, Y, Z, W>& state) noexcept override { m_Flips.apply(state); }
+
+        void revert(::State::State<X, Y, Z, W>& state) const noexcept override { m_Flips.apply(state); }
 
-        void revert(::State::State<X, Y, Z, W>& state) const noexcept override {
-            apply(state);
+        void reset() noexcept override { m_Flips.clear(); }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            m_Flips.collectChangedLocations(locations);
+            return true;
         }
 
     protected:
         inline static Random::RandomGenerator& m_Random = Random::generator();
 
-        axis_size_t m_Y1 {}, m_Y2 {};
-        std::unordered_map<HorizontalExchangeAssignLocation, uint8_t> m_LocationXors {};
+        FlipList<128> m_Flips {};
+
+        [[nodiscard]] static bool hasAssignment(const ::State::State<X, Y, Z, W>& state, const axis_size_t y, const axis_size_t z) noexcept {
+            const auto assigned = state.setLocations(::State::ANY, y, z);
+            return assigned.begin() != assigned.end();
+        }
+
+        /**
+         * @return Number of Xs with an assignment at (`y`, `z`), i.e. the number of Xs `exchange` toggles there.
+         */
+        [[nodiscard]] static uint32_t assignedXCount(const ::State::State<X, Y, Z, W>& state, const axis_size_t y, const axis_size_t z) noexcept {
+            uint32_t count = 0;
+            axis_size_t previousX = ::State::ANY;
+            for (const auto& location : state.setLocations(::State::ANY, y, z)) {
+                if (location.x == previousX) continue;
+                previousX = location.x;
+                ++count;
+            }
+            return count;
+        }
 
-        void apply(::State::State<X, Y, Z, W>& state) const noexcept {
-            for (const auto& entry : m_LocationXors) {
-                const auto& [x, z, w] = entry.first;
-                const uint8_t v1 = state.get(x, m_Y1, z, w) ^ entry.second;
-                const uint8_t v2 = state.get(x, m_Y2, z, w) ^ entry.second;
-                state.assign(x, m_Y1, z, w, v1);
-                state.assign(x, m_Y2, z, w, v2);
+        /**
+         * Toggles the first assigned concept of every X at (`y`, `z`) for both Ys.
+         */
+        void exchange(const ::State::State<X, Y, Z, W>& state, const axis_size_t y1, const axis_size_t y2,
+                      const axis_size_t y, const axis_size_t z) noexcept {
+            axis_size_t previousX = ::State::ANY;
+            for (const auto& location : state.setLocations(::State::ANY, y, z)) {
+                if (location.x == previousX) continue; // Only the first concept of each X
+                previousX = location.x;
+                m_Flips.flip(::State::Location {location.x, y1, z, location.w});
+                m_Flips.flip(::State::Location {location.x, y2, z, location.w});
             }
         }
     };
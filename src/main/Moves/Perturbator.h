@@ -1,7 +1,10 @@
 #ifndef PERTURBATOR_H
 #define PERTURBATOR_H
 
+#include <vector>
+
 #include "State/State.h"
+#include "State/Location.h"
 
 namespace Moves {
     using axis_size_t = ::State::axis_size_t;
@@ -39,6 +42,22 @@ namespace Moves {
         virtual void modify(::State::State<X, Y, Z, W>& state) noexcept = 0;
         virtual void revert(::State::State<X, Y, Z, W>& state) const noexcept = 0;
 
+        /**
+         * Drops the current configuration so this perturbator can be configured again (see `PerturbatorPool`).
+         * Buffers keep their capacity.
+         */
+        virtual void reset() noexcept { }
+
+        /**
+         * Appends every location this perturbator (with current configuration) may write to. Locations may repeat and
+         * may include bits whose value ends up unchanged; the evaluator normalizes them.
+         * @param locations Change set to append to.
+         * @return `true` if the change set is reported, `false` if this perturbator can't report its changes.
+         */
+        [[nodiscard]] virtual bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept {
+            return false;
+        }
+
         constexpr void operator()(::State::State<X, Y, Z, W>& state) noexcept { modify(state); }
 
     protected:
@@ -1,45 +1,70 @@
 #ifndef PERTURBATORCHAIN_H
 #define PERTURBATORCHAIN_H
 
+#include <cassert>
 #include <vector>
 
 #include "Perturbator.h"
+#include "PerturbatorPool.h"
 
 #define MAX_PERTURBATOR_HISTORY_SIZE 500
 
 namespace Moves {
+    /**
+     * Sequence of perturbators applied together. The chain owns handles into a `PerturbatorPool` and hands the
+     * perturbators and its handle storage back to the pool when they're dropped; a chain without a pool adopts the pool
+     * of the first chain appended to it.<br>
+     * At most `MAX_PERTURBATOR_HISTORY_SIZE` handles are kept: the storage grows up to that size and then becomes a
+     * ring buffer in which each push evicts the oldest handle in O(1).
+     */
     template<typename X, typename Y, typename Z, typename W>
     class PerturbatorChain {
     public:
+        using Handle = PooledPerturbator<X, Y, Z, W>;
+
         explicit PerturbatorChain() noexcept : m_Perturbators{} { }
-        explicit PerturbatorChain(const std::vector<Perturbator<X, Y, Z, W> *>& perturbators) noexcept : m_Perturbators(perturbators) { }
+        explicit PerturbatorChain(PerturbatorPool<X, Y, Z, W>& pool) noexcept : mp_Pool(&pool), m_Perturbators(pool.acquireStorage()) { }
         PerturbatorChain(const PerturbatorChain&) = delete;
-        PerturbatorChain(PerturbatorChain&& other) noexcept {
-            m_Perturbators = std::move(other.m_Perturbators);
-            m_DeletePerturbatorsOnDestroy = other.m_DeletePerturbatorsOnDestroy;
-            other.m_DeletePerturbatorsOnDestroy = false;
+        PerturbatorChain(PerturbatorChain&& other) noexcept : mp_Pool(other.mp_Pool), m_Perturbators(std::move(other.m_Perturbators)), m_Head(other.m_Head) {
+            other.m_Perturbators.clear();
+            other.m_Head = 0;
         }
         ~PerturbatorChain() noexcept {
-            if (m_DeletePerturbatorsOnDestroy)
-                for (auto *perturbator : m_Perturbators) { delete perturbator; }
+            releaseAll();
+            if (mp_Pool != nullptr) mp_Pool->releaseStorage(std::move(m_Perturbators));
         }
 
         [[nodiscard]] size_t size() const noexcept { return m_Perturbators.size(); }
         [[nodiscard]] bool empty() const noexcept { return m_Perturbators.empty(); }
 
         void clear() noexcept {
-            if (m_DeletePerturbatorsOnDestroy)
-                for (auto *perturbator : m_Perturbators) { delete perturbator; }
-            m_DeletePerturbatorsOnDestroy = true;
+            releaseAll();
             m_Perturbators.clear();
+            m_Head = 0;
         }
 
         void modify(::State::State<X, Y, Z, W>& state) noexcept {
-            for (auto *perturbator : m_Perturbators) perturbator->modify(state);
+            forEachOldestFirst([&](const Handle& handle) { handle.perturbator->modify(state); });
         }
 
+        /**
+         * Reverts the perturbators newest first, undoing `modify`.
+         */
         void revert(::State::State<X, Y, Z, W>& state) const noexcept {
-            for (auto it = m_Perturbators.rbegin(); it != m_Perturbators.rend(); ++it) (*it)->revert(state);
+            forEachNewestFirst([&](const Handle& handle) { handle.perturbator->revert(state); });
+        }
+
+        /**
+         * Collects the change set of all perturbators in this chain.
+         * @param locations Change set to append to.
+         * @return `true` if every perturbator reported its changes; `false` otherwise (change set is then incomplete).
+         */
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept {
+            bool complete = true;
+            forEachOldestFirst([&](const Handle& handle) {
+                complete = complete && handle.perturbator->collectChangedLocations(locations);
+            });
+            return complete;
         }
 
         constexpr void operator()(::State::State<X, Y, Z, W>& state) noexcept { modify(state); }
@@ -47,35 +72,82 @@ namespace Moves {
         PerturbatorChain& operator=(const PerturbatorChain&) = delete;
         [[nodiscard]] PerturbatorChain& operator=(PerturbatorChain&& other) noexcept {
             if (this != &other) [[likely]] {
-                if (m_DeletePerturbatorsOnDestroy)
-                    for (auto *perturbator : m_Perturbators) { delete perturbator; }
+                releaseAll();
+                if (mp_Pool != nullptr) mp_Pool->releaseStorage(std::move(m_Perturbators));
+                mp_Pool = other.mp_Pool;
                 m_Perturbators = std::move(other.m_Perturbators);
-                m_DeletePerturbatorsOnDestroy = other.m_DeletePerturbatorsOnDestroy;
-                other.m_DeletePerturbatorsOnDestroy = false;
+                m_Head = other.m_Head;
+                other.m_Perturbators.clear();
+                other.m_Head = 0;
             }
             return *this;
         }
 
+        /**
+         * Moves the perturbators of `other` to the end of this chain; `other` is left empty.
+         */
         void append(PerturbatorChain& other) noexcept {
-            other.m_DeletePerturbatorsOnDestroy = false;
-            for (auto *perturbator : other.m_Perturbators) push(perturbator);
+            if (mp_Pool == nullptr && other.mp_Pool != nullptr) {
+                mp_Pool = other.mp_Pool;
+                if (m_Perturbators.empty()) m_Perturbators = mp_Pool->acquireStorage();
+            }
+            assert((other.mp_Pool == nullptr || other.mp_Pool == mp_Pool) && "Chains must share a pool.");
+            other.forEachOldestFirst([&](const Handle& handle) { push(handle); });
+            other.m_Perturbators.clear();
+            other.m_Head = 0;
         }
 
-        void push(Perturbator<X, Y, Z, W> *p) noexcept {
-            if (m_Perturbators.size() >= MAX_PERTURBATOR_HISTORY_SIZE) {
-                delete *m_Perturbators.begin();
-                m_Perturbators.erase(m_Perturbators.begin());
+        /**
+         * Appends a handle; once the chain is full, the oldest handle is evicted and released.
+         */
+        void push(const Handle& handle) noexcept {
+            if (m_Perturbators.size() < MAX_PERTURBATOR_HISTORY_SIZE) {
+                m_Perturbators.push_back(handle);
+                return;
             }
-            m_Perturbators.push_back(p);
+            release(m_Perturbators[m_Head]);
+            m_Perturbators[m_Head] = handle;
+            if (++m_Head == m_Perturbators.size()) m_Head = 0;
         }
 
+        /**
+         * @return Perturbators oldest first.
+         */
         std::vector<Perturbator<X, Y, Z, W> *> perturbators() const {
-            return m_Perturbators;
+            std::vector<Perturbator<X, Y, Z, W> *> perturbators;
+            perturbators.reserve(m_Perturbators.size());
+            forEachOldestFirst([&](const Handle& handle) { perturbators.push_back(handle.perturbator); });
+            return perturbators;
         }
 
     protected:
-        bool m_DeletePerturbatorsOnDestroy = true;
-        std::vector<Perturbator<X, Y, Z, W> *> m_Perturbators;
+        PerturbatorPool<X, Y, Z, W> *mp_Pool = nullptr;
+        std::vector<Handle> m_Perturbators;
+        size_t m_Head = 0; // Oldest handle once the ring is full; 0 before.
+
+        template<typename F>
+        void forEachOldestFirst(F&& f) const noexcept {
+            for (size_t i = m_Head; i < m_Perturbators.size(); ++i) f(m_Perturbators[i]);
+            for (size_t i = 0; i < m_Head; ++i) f(m_Perturbators[i]);
+        }
+
+        template<typename F>
+        void forEachNewestFirst(F&& f) const noexcept {
+            for (size_t i = m_Head; i > 0; --i) f(m_Perturbators[i - 1]);
+            for (size_t i = m_Perturbators.size(); i > m_Head; --i) f(m_Perturbators[i - 1]);
+        }
+
+        void release(const Handle& handle) noexcept {
+            if (mp_Pool != nullptr) {
+                mp_Pool->release(handle);
+            } else {
+                delete handle.perturbator;
+            }
+        }
+
+        void releaseAll() noexcept {
+            for (const auto& handle : m_Perturbators) release(handle);
+        }
 
         friend class HeuristicProvider<X, Y, Z, W>;
     };
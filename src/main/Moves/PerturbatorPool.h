@@ -0,0 +1,104 @@
+#ifndef PERTURBATORPOOL_H
+#define PERTURBATORPOOL_H
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "Perturbator.h"
+#include "AutonomousPerturbator.h"
+
+namespace Moves {
+    /**
+     * Perturbator owned by a `PerturbatorPool`, together with the free list it returns to.
+     */
+    template<typename X, typename Y, typename Z, typename W>
+    struct PooledPerturbator {
+        Perturbator<X, Y, Z, W> *perturbator;
+        uint32_t kind;
+    };
+
+    /**
+     * Typed object pool of perturbators, owned by one search task (see `HeuristicProvider`).<br>
+     * Every prototype gets a kind with its own free list: `acquire` reuses a released clone and only clones the
+     * prototype when the list is empty, and `release` resets the clone (see `Perturbator::reset`) and puts it back.
+     * Handle storage of chains is recycled the same way, so configuring and discarding moves doesn't allocate once the
+     * free lists are warm. Prototypes must outlive the pool, and the pool must outlive every chain using it.
+     */
+    template<typename X, typename Y, typename Z, typename W>
+    class PerturbatorPool {
+    public:
+        using Handle = PooledPerturbator<X, Y, Z, W>;
+
+        /**
+         * Kind of perturbators that aren't cloned from a prototype; they're deleted on release.
+         */
+        static constexpr uint32_t UNPOOLED = std::numeric_limits<uint32_t>::max();
+
+        explicit PerturbatorPool() noexcept = default;
+        PerturbatorPool(const PerturbatorPool&) = delete;
+        PerturbatorPool& operator=(const PerturbatorPool&) = delete;
+
+        ~PerturbatorPool() noexcept {
+            for (const auto& free : m_Free)
+                for (const auto *perturbator : free) delete perturbator;
+        }
+
+        /**
+         * @return Kind of clones of `prototype`; registered on first use.
+         */
+        [[nodiscard]] uint32_t kindOf(const AutonomousPerturbator<X, Y, Z, W> *prototype) noexcept {
+            const auto [it, inserted] = m_Kinds.try_emplace(prototype, static_cast<uint32_t>(m_Prototypes.size()));
+            if (inserted) {
+                m_Prototypes.push_back(prototype);
+                m_Free.emplace_back();
+            }
+            return it->second;
+        }
+
+        /**
+         * @return Unconfigured perturbator of the given kind; hand it back with `release` or through a chain.
+         */
+        [[nodiscard]] AutonomousPerturbator<X, Y, Z, W> *acquire(const uint32_t kind) noexcept {
+            auto& free = m_Free[kind];
+            if (free.empty()) [[unlikely]] return m_Prototypes[kind]->clone();
+            auto *perturbator = free.back();
+            free.pop_back();
+            return perturbator;
+        }
+
+        void release(const Handle& handle) noexcept {
+            if (handle.kind == UNPOOLED) {
+                delete handle.perturbator;
+                return;
+            }
+            handle.perturbator->reset();
+            m_Free[handle.kind].push_back(static_cast<AutonomousPerturbator<X, Y, Z, W> *>(handle.perturbator));
+        }
+
+        /**
+         * @return Empty handle storage for a chain, with the capacity of a released one if available.
+         */
+        [[nodiscard]] std::vector<Handle> acquireStorage() noexcept {
+            if (m_FreeStorage.empty()) return {};
+            std::vector<Handle> storage = std::move(m_FreeStorage.back());
+            m_FreeStorage.pop_back();
+            return storage;
+        }
+
+        void releaseStorage(std::vector<Handle>&& storage) noexcept {
+            if (storage.capacity() == 0) return;
+            storage.clear();
+            m_FreeStorage.push_back(std::move(storage));
+        }
+
+    private:
+        std::unordered_map<const AutonomousPerturbator<X, Y, Z, W> *, uint32_t> m_Kinds;
+        std::vector<const AutonomousPerturbator<X, Y, Z, W> *> m_Prototypes;
+        std::vector<std::vector<AutonomousPerturbator<X, Y, Z, W> *>> m_Free; // Per kind.
+        std::vector<std::vector<Handle>> m_FreeStorage;
+    };
+}
+
+#endif //PERTURBATORPOOL_H
@@ -1,6 +1,7 @@
 #ifndef RANDOMASSIGNMENTTOGGLEPERTURBATOR_H
 #define RANDOMASSIGNMENTTOGGLEPERTURBATOR_H
 
+#include "AssignmentCandidates.h"
 #include "AutonomousPerturbator.h"
 
 #include "Utils/Random.h"
@@ -9,7 +10,11 @@ namespace Moves {
     template<typename X, typename Y, typename Z, typename W>
     class RandomAssignmentTogglePerturbator final : public AutonomousPerturbator<X, Y, Z, W> {
     public:
-        explicit RandomAssignmentTogglePerturbator() noexcept {
+        /**
+         * @param candidates Eligible assignments to sample from; the whole state is sampled if not given.
+         */
+        explicit RandomAssignmentTogglePerturbator(const AssignmentCandidates *candidates = nullptr) noexcept :
+            mp_Candidates(candidates) {
             // TODO: determine min Z width to assign at once (for now it is 2).
             //   There must always be a probability that only 1 z will be assigned (for later on in the search process).
             m_MaxZWidth = 2;
@@ -20,16 +25,27 @@ namespace Moves {
         }
 
         void configure(const ::State::State<X, Y, Z, W>& state) noexcept override {
-            m_Location = ::State::Location {
-                m_Random.randomInt(0, state.sizeX() - 1),
-                m_Random.randomInt(0, state.sizeY() - 1),
-                m_Random.randomInt(0, state.sizeZ() - 1),
-                m_Random.randomInt(0, state.sizeW() - 1)
-            };
+            if (mp_Candidates != nullptr && mp_Candidates->count() > 0) [[likely]] {
+                m_Location = mp_Candidates->at(m_Random.randomInt(0, static_cast<uint32_t>(mp_Candidates->count() - 1)));
+            } else {
+                m_Location = ::State::Location {
+                    m_Random.randomInt(0, state.sizeX() - 1),
+                    m_Random.randomInt(0, state.sizeY() - 1),
+                    m_Random.randomInt(0, state.sizeZ() - 1),
+                    m_Random.randomInt(0, state.sizeW() - 1)
+                };
+            }
             m_ZSideIncrement = m_Random.randomInt(0, state.sizeZ() >= m_MaxZWidth ? m_MaxZWidth - 1 : state.sizeZ());
             if (m_Location.z + m_ZSideIncrement >= state.sizeZ()) {
                 m_ZSideIncrement = 0;
             }
+            // The following days must not become assignments that aren't eligible either
+            for (int32_t i = 1; i <= m_ZSideIncrement; ++i) {
+                const auto next = m_Location.withZ(m_Location.z + i);
+                if (mp_Candidates == nullptr || state.get(next) || mp_Candidates->isEligible(next)) continue;
+                m_ZSideIncrement = i - 1;
+                break;
+            }
         }
 
         [[nodiscard]] bool isIdentity() const noexcept override { return false; }
@@ -41,8 +57,16 @@ namespace Moves {
         void revert(::State::State<X, Y, Z, W>& state) const noexcept override {
             apply(state);
         }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            for (int32_t i = 0; i <= m_ZSideIncrement; ++i) {
+                locations.emplace_back(m_Location.x, m_Location.y, m_Location.z + i, m_Location.w);
+            }
+            return true;
+        }
     private:
         inline static Random::RandomGenerator& m_Random = Random::generator();
+        const AssignmentCandidates *mp_Candidates; // Owned by the heuristic provider.
         axis_size_t m_MaxZWidth = 1;
         int32_t m_ZSideIncrement = 1;
         ::State::Location m_Location{};
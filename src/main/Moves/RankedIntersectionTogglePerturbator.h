@@ -1,17 +1,22 @@
 #ifndef RANKEDINTERSECTIONTOGGLEPERTURBATOR_H
 #define RANKEDINTERSECTIONTOGGLEPERTURBATOR_H
 
+#include "AssignmentCandidates.h"
 #include "AutonomousPerturbator.h"
+#include "FlipList.h"
 
 #include "Utils/Random.h"
 
-#include <unordered_map>
-
 namespace Moves {
     template<typename X, typename Y, typename Z, typename W>
     class RankedIntersectionTogglePerturbator : public AutonomousPerturbator<X, Y, Z, W> {
     public:
-        explicit RankedIntersectionTogglePerturbator(const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints) noexcept {
+        /**
+         * @param candidates Eligible assignments; new assignments are only made among them if given.
+         */
+        explicit RankedIntersectionTogglePerturbator(const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints,
+                                                     const AssignmentCandidates *candidates = nullptr) noexcept :
+            mp_Candidates(candidates) {
             for (size_t i = 0; i < constraints.size(); ++i) {
                 const auto* constraint = constraints[i];
                 if (constraint->name() == "EMPLOYMENT_MAX_DURATION")
@@ -33,10 +38,15 @@ namespace Moves {
 
         [[nodiscard]] bool configureIfApplicable(const Evaluation::Evaluator<X, Y, Z, W>& evaluator,
                                                  const ::State::State<X, Y, Z, W>& state) noexcept override {
-            const auto& coverageConstraintScore = evaluator.constraintScores()[m_CoverageConstraintIndex];
-            const auto& maxDurationConstraintScore = evaluator.constraintScores()[m_EmployeeMaxDurationConstraintIndex];
+            m_Flips.reset(state.size());
+            if (evaluator.constraintScores()[m_CoverageConstraintIndex].score().isFeasible() &&
+                evaluator.constraintScores()[m_EmployeeMaxDurationConstraintIndex].score().isFeasible())
+                return false;
+
+            const auto& coverageConstraintScore = evaluator.constraintScore(m_CoverageConstraintIndex, state);
+            const auto& maxDurationConstraintScore = evaluator.constraintScore(m_EmployeeMaxDurationConstraintIndex, state);
 
-            if ((coverageConstraintScore.score().isFeasible() && maxDurationConstraintScore.score().isFeasible()) || (coverageConstraintScore.violations().empty() || maxDurationConstraintScore.violations().empty()))
+            if (coverageConstraintScore.violations().empty() || maxDurationConstraintScore.violations().empty())
                 return false;
 
             // max duration constraint: info = 2 if you can assign more shifts, 1 if max workload is already reached
@@ -62,23 +72,17 @@ namespace Moves {
                 };
 
                 if (maxDurationViolation.info == 2 && coverageViolation.info == 2) {
-                    if (!state.get(location)) {
-                        m_LocationXors.emplace(location, 1);
-                        if (state.sizeZ() > 1 && m_Random.randomInt(0, 10) < 8) {
-                            if (location.z + 1 == state.sizeZ()) {
-                                m_LocationXors.emplace(location.withZ(location.z - 1), 1);
-                            } else {
-                                m_LocationXors.emplace(location.withZ(location.z + 1), 1);
-                            }
-                        }
+                    if (!state.get(location) && isEligible(location)) {
+                        m_Flips.flip(location);
+                        flipNeighbouringDay(state, location);
                     }
                 } else if (state.get(location)) {
-                    m_LocationXors.emplace(location, 1);
+                    m_Flips.flip(location);
                     if (state.sizeZ() > 1 && m_Random.randomInt(0, 10) < 8) {
                         if (location.z + 1 == state.sizeZ()) {
-                            m_LocationXors.emplace(location.withZ(location.z - 1), 1);
+                            m_Flips.flip(location.withZ(location.z - 1));
                         } else {
-                            m_LocationXors.emplace(location.withZ(location.z + 1), 1);
+                            m_Flips.flip(location.withZ(location.z + 1));
                         }
                     }
                 }
@@ -88,58 +92,85 @@ namespace Moves {
                 const axis_size_t z = coverageViolation.getZ();
 
                 if (maxDurationViolation.info == 2 && coverageViolation.info == 2) {
-                    if (!state.get(x, y, z)) {
-                        const auto location = ::State::Location{x, y, z, m_Random.randomInt(0, state.sizeW() - 1)};
-                        m_LocationXors.emplace(location, 1);
-                        if (state.sizeZ() > 1 && m_Random.randomInt(0, 10) < 8) {
-                            if (location.z + 1 == state.sizeZ()) {
-                                m_LocationXors.emplace(location.withZ(location.z - 1), 1);
-                            } else {
-                                m_LocationXors.emplace(location.withZ(location.z + 1), 1);
-                            }
-                        }
+                    axis_size_t w;
+                    if (!state.get(x, y, z) && sampleW(state, x, y, z, w)) {
+                        const auto location = ::State::Location{x, y, z, w};
+                        m_Flips.flip(location);
+                        flipNeighbouringDay(state, location);
                     }
                 } else {
-                    for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                        if (state.get(x, y, z, w)) {
-                            m_LocationXors.emplace(::State::Location{x, y, z, w}, 1);
-                            if (state.sizeZ() > 1 && m_Random.randomInt(0, 10) < 8) {
-                                if (z + 1 == state.sizeZ()) {
-                                    m_LocationXors.emplace(::State::Location {x, y, z - 1, w}, 1);
-                                } else {
-                                    m_LocationXors.emplace(::State::Location {x, y, z + 1, w}, 1);
-                                }
+                    const auto assigned = state.setLocations(x, y, z);
+                    if (const auto it = assigned.begin(); it != assigned.end()) {
+                        const axis_size_t w = (*it).w;
+                        m_Flips.flip(::State::Location{x, y, z, w});
+                        if (state.sizeZ() > 1 && m_Random.randomInt(0, 10) < 8) {
+                            if (z + 1 == state.sizeZ()) {
+                                m_Flips.flip(::State::Location {x, y, z - 1, w});
+                            } else {
+                                m_Flips.flip(::State::Location {x, y, z + 1, w});
                             }
-                            break;
                         }
                     }
                 }
             }
 
-            return !m_LocationXors.empty();
+            return !m_Flips.empty();
         }
 
         void configure(const ::State::State<X, Y, Z, W>& state) noexcept override {
 
         }
 
-        [[nodiscard]] bool isIdentity() const noexcept override { return m_LocationXors.empty(); }
+        [[nodiscard]] bool isIdentity() const noexcept override { return m_Flips.empty(); }
+
+        void modify(::State::State<X, Y, Z, W>& state) noexcept override { m_Flips.apply(state); }
 
-        void modify(::State::State<X, Y, Z, W>& state) noexcept override { apply(state); }
+        void revert(::State::State<X, Y, Z, W>& state) const noexcept override { m_Flips.apply(state); }
 
-        void revert(::State::State<X, Y, Z, W>& state) const noexcept override { apply(state); }
+        void reset() noexcept override { m_Flips.clear(); }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            m_Flips.collectChangedLocations(locations);
+            return true;
+        }
 
     protected:
         inline static Random::RandomGenerator& m_Random = Random::generator();
 
         size_t m_CoverageConstraintIndex, m_EmployeeMaxDurationConstraintIndex;
+        const AssignmentCandidates *mp_Candidates; // Owned by the heuristic provider.
 
-        std::unordered_map<::State::Location, uint8_t> m_LocationXors {};
+        FlipList<2> m_Flips {}; // The toggled location and possibly a neighbouring day.
 
-        void apply(::State::State<X, Y, Z, W>& state) const noexcept {
-            for (const auto& [loc, val] : m_LocationXors) {
-                state.assign(loc, state.get(loc) ^ val);
+        [[nodiscard]] bool isEligible(const ::State::Location& location) const noexcept {
+            return mp_Candidates == nullptr || mp_Candidates->isEligible(location);
+        }
+
+        /**
+         * Picks the concept of a new assignment of (`x`, `y`, `z`) uniformly among the eligible ones.
+         * @return `false` if there is none.
+         */
+        bool sampleW(const ::State::State<X, Y, Z, W>& state, const axis_size_t x, const axis_size_t y,
+                     const axis_size_t z, axis_size_t& w) const noexcept {
+            if (mp_Candidates == nullptr) {
+                w = m_Random.randomInt(0, state.sizeW() - 1);
+                return true;
+            }
+            uint32_t count = 0;
+            for (const auto& pair : mp_Candidates->pairs(x, z)) {
+                if (pair.y == y && m_Random.randomInt(0, count++) == 0) w = pair.w;
             }
+            return count > 0;
+        }
+
+        /**
+         * Usually also toggles the next day (or the previous one on the last day), unless that would make an assignment
+         * that isn't eligible.
+         */
+        void flipNeighbouringDay(const ::State::State<X, Y, Z, W>& state, const ::State::Location& location) noexcept {
+            if (state.sizeZ() <= 1 || m_Random.randomInt(0, 10) >= 8) return;
+            const auto neighbour = location.withZ(location.z + 1 == state.sizeZ() ? location.z - 1 : location.z + 1);
+            if (state.get(neighbour) || isEligible(neighbour)) m_Flips.flip(neighbour);
         }
     };
 }
@@ -5,6 +5,8 @@
 
 #include "Utils/Random.h"
 
+#include <algorithm>
+#include <tuple>
 #include <unordered_map>
 
 namespace Moves {
@@ -24,32 +26,33 @@ namespace Moves {
         }
 
         void configure(const ::State::State<X, Y, Z, W>& state) noexcept override {
-            std::vector<axis_size_t> employeesWithWork;
-            for (axis_size_t x = 0; x < state.sizeX(); x++) {
-                for (axis_size_t z = 0; z < state.sizeZ(); z++) {
-                    for (axis_size_t y = 0; y < state.sizeY(); y++) {
-                        if (state.get(x, y, z))
-                            employeesWithWork.push_back(y);
-                    }
-                }
+            // Scratch buffers are members so that a pooled perturbator reuses their capacity
+            auto& employeesWithWork = m_EmployeesWithWork;
+            auto& assignments = m_Assignments;
+            auto& chains = m_Chains;
+            employeesWithWork.clear();
+            assignments.clear();
+            chains.clear();
+
+            // One entry per assigned (x, y, z) cell; the concepts of a cell are yielded consecutively
+            ::State::Location previous {::State::ANY, ::State::ANY, ::State::ANY, ::State::ANY};
+            for (const auto& location : state.setLocations()) {
+                if (location.x != previous.x || location.y != previous.y || location.z != previous.z)
+                    employeesWithWork.push_back(location.y);
+                previous = location;
             }
             if (employeesWithWork.empty()) return;
 
             const axis_size_t y = m_Random.choice(employeesWithWork);
 
-            std::vector<::State::Location> assignments;
-            for (axis_size_t z = 0; z < state.sizeZ(); ++z) {
-                for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                    for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                        if (!state.get(x, y, z, w)) continue;
-                        assignments.push_back(::State::Location{x, y, z, w});
-                    }
-                }
-            }
+            for (const auto& location : state.setLocations(::State::ANY, y)) assignments.push_back(location);
+            // Chains are runs of consecutive Z; same order as a stable sort by Z, without its temporary buffer
+            std::ranges::sort(assignments, {}, [](const ::State::Location& location) {
+                return std::tuple(location.z, location.x, location.w);
+            });
 
             if (assignments.empty()) return;
 
-            std::vector<std::pair<axis_size_t, axis_size_t>> chains;
             axis_size_t start = 0;
             for (size_t i = 1; i < assignments.size(); ++i) {
                 if (assignments[i].z != assignments[i - 1].z + 1) {
@@ -96,11 +99,26 @@ namespace Moves {
                 state.set(assignLocation);
         }
 
+        void reset() noexcept override {
+            m_UnassignLocations.clear();
+            m_AssignLocations.clear();
+        }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            locations.insert(locations.end(), m_UnassignLocations.begin(), m_UnassignLocations.end());
+            locations.insert(locations.end(), m_AssignLocations.begin(), m_AssignLocations.end());
+            return true;
+        }
+
     protected:
         inline static Random::RandomGenerator& m_Random = Random::generator();
 
         std::vector<::State::Location> m_UnassignLocations {};
         std::vector<::State::Location> m_AssignLocations {};
+
+        std::vector<axis_size_t> m_EmployeesWithWork {};
+        std::vector<::State::Location> m_Assignments {};
+        std::vector<std::pair<axis_size_t, axis_size_t>> m_Chains {};
     };
 }
 
@@ -54,6 +54,15 @@ namespace Moves {
             }
         }
 
+        void reset() noexcept override {
+            m_Locations.clear();
+        }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            locations.insert(locations.end(), m_Locations.begin(), m_Locations.end());
+            return true;
+        }
+
     protected:
         std::vector<::State::Location> m_Locations {};
     };
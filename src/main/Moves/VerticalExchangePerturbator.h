@@ -2,12 +2,10 @@
 #define VERTICALEXCHANGEPERTURBATOR_H
 
 #include "AutonomousPerturbator.h"
-#include "Structs/VerticalExchangeAssignLocation.h"
+#include "FlipList.h"
 
 #include "Utils/Random.h"
 
-#include <unordered_map>
-
 namespace Moves {
     template<typename X, typename Y, typename Z, typename W>
     class VerticalExchangePerturbator : public AutonomousPerturbator<X, Y, Z, W> {
@@ -20,6 +18,7 @@ namespace Moves {
         }
 
         void configure(const ::State::State<X, Y, Z, W>& state) noexcept override {
+            m_Flips.reset(state.size());
             if (state.sizeZ() < 2 || state.sizeY() < 1) return;
 
             const axis_size_t z1 = m_Random.randomInt(state.sizeZ() - 1);
@@ -28,82 +27,71 @@ namespace Moves {
 
             const axis_size_t randomY = m_Random.randomInt(state.sizeY() - 1);
 
-            bool startYInitialized = false;
-            axis_size_t startY = 0, endY = 0;
-            std::unordered_map<VerticalExchangeAssignLocation, uint8_t> locations1 {};
-            locations1.reserve(5);
+            // The block starts at the first Y from `randomY` on with an assignment at `z1` and runs while Ys have one.
+            // Each assignment of the block at `z1` or `z2` is toggled at both, so the two columns swap.
+            bool started = false;
             for (axis_size_t yi = randomY; yi < state.sizeY() + randomY; ++yi) {
                 const axis_size_t y = yi % state.sizeY();
-                bool assignedAtY = false;
-                for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                    for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                        if (state.get(x, y, z1, w)) {
-                            assignedAtY = true;
-                            if (!startYInitialized) {
-                                startYInitialized = true;
-                                startY = y;
-                            }
-                            locations1.emplace(VerticalExchangeAssignLocation{x, y, w}, 1);
-                            break;
-                        }
-                    }
-                }
-                if (startYInitialized && !assignedAtY) {
-                    endY = y;
-                    break;
-                }
-            }
-            std::unordered_map<VerticalExchangeAssignLocation, uint8_t> locations2 {};
-            locations2.reserve(endY >= startY ? endY - startY : state.sizeZ() - startY + endY);
-            for (axis_size_t y = startY; y < endY; ++y) {
-                for (axis_size_t x = 0; x < state.sizeX(); ++x) {
-                    for (axis_size_t w = 0; w < state.sizeW(); ++w) {
-                        if (state.get(x, y, z2, w)) {
-                            locations2.emplace(VerticalExchangeAssignLocation{x, y, w}, 1);
-                            break;
-                        }
-                    }
-                }
-            }
-
-            m_Z1 = z1;
-            m_Z2 = z2;
-            m_LocationXors = std::move(locations1);
-            for (const auto& entry : locations2) {
-                auto loc1 = m_LocationXors.find(entry.first);
-                if (loc1 != m_LocationXors.end()) {
-                    loc1->second ^= entry.second;
-                } else {
-                    m_LocationXors.emplace(entry.first, entry.second);
+                if (!hasAssignment(state, y, z1)) {
+                    if (started) break;
+                    continue;
                 }
+                // Each toggled X takes up to two new words; stop early rather than drop half a row
+                if (m_Flips.remaining() < 2 * (assignedXCount(state, y, z1) + assignedXCount(state, y, z2))) break;
+                started = true;
+                exchange(state, y, z1, z2, z1);
+                exchange(state, y, z1, z2, z2);
             }
         }
 
-        [[nodiscard]] bool isIdentity() const noexcept override {
-            return m_Z1 == m_Z2 || m_LocationXors.empty();
-        }
+        [[nodiscard]] bool isIdentity() const noexcept override { return m_Flips.empty(); }
 
-        void modify(::State::State<X, Y, Z, W>& state) noexcept override {
-            apply(state);
-        }
+        void modify(::State::State<X, Y, Z, W>& state) noexcept override { m_Flips.apply(state); }
+
+        void revert(::State::State<X, Y, Z, W>& state) const noexcept override { m_Flips.apply(state); }
 
-        void revert(::State::State<X, Y, Z, W>& state) const noexcept override {
-            apply(state);
+        void reset() noexcept override { m_Flips.clear(); }
+
+        [[nodiscard]] bool collectChangedLocations(std::vector<::State::Location>& locations) const noexcept override {
+            m_Flips.collectChangedLocations(locations);
+            return true;
         }
 
     protected:
         inline static Random::RandomGenerator& m_Random = Random::generator();
 
-        axis_size_t m_Z1 {}, m_Z2 {};
-        std::unordered_map<VerticalExchangeAssignLocation, uint8_t> m_LocationXors {};
+        FlipList<128> m_Flips {};
+
+        [[nodiscard]] static bool hasAssignment(const ::State::State<X, Y, Z, W>& state, const axis_size_t y, const axis_size_t z) noexcept {
+            const auto assigned = state.setLocations(::State::ANY, y, z);
+            return assigned.begin() != assigned.end();
+        }
+
+        /**
+         * @return Number of Xs with an assignment at (`y`, `z`), i.e. the number of Xs `exchange` toggles there.
+         */
+        [[nodiscard]] static uint32_t assignedXCount(const ::State::State<X, Y, Z, W>& state, const axis_size_t y, const axis_size_t z) noexcept {
+            uint32_t count = 0;
+            axis_size_t previousX = ::State::ANY;
+            for (const auto& location : state.setLocations(::State::ANY, y, z)) {
+                if (location.x == previousX) continue;
+                previousX = location.x;
+                ++count;
+            }
+            return count;
+        }
 
-        void apply(::State::State<X, Y, Z, W>& state) const noexcept {
-            for (const auto& entry : m_LocationXors) {
-                const auto& [x, y, w] = entry.first;
-                const uint8_t v1 = state.get(x, y, m_Z1, w) ^ entry.second;
-                const uint8_t v2 = state.get(x, y, m_Z2, w) ^ entry.second;
-                state.assign(x, y, m_Z1, w, v1);
-                state.assign(x, y, m_Z2, w, v2);
+        /**
+         * Toggles the first assigned concept of every X at (`y`, `z`) on both days.
+         */
+        void exchange(const ::State::State<X, Y, Z, W>& state, const axis_size_t y, const axis_size_t z1,
+                      const axis_size_t z2, const axis_size_t z) noexcept {
+            axis_size_t previousX = ::State::ANY;
+            for (const auto& location : state.setLocations(::State::ANY, y, z)) {
+                if (location.x == previousX) continue; // Only the first concept of each X
+                previousX = location.x;
+                m_Flips.flip(location.withZ(z1));
+                m_Flips.flip(location.withZ(z2));
             }
         }
     };
@@ -5,11 +5,14 @@
 #define PRINT_CONSTRAINT_DEBUG_INFO
 #endif
 
+#include "Array/BitArray.h"
 #include "Constraints/Constraint.h"
 #include "Constraints/ConstraintScore.h"
 #include "Score/Score.h"
 #include "State/State.h"
+#include "State/Location.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -26,16 +29,27 @@ namespace Evaluation {
         Score::Score score {};
         // ReSharper disable once CppRedundantQualifier
         for (::Constraints::Constraint<X, Y, Z, W> *constraint : constraints)
-            score += constraint->evaluate(state);
+            score += constraint->evaluate(state, ::Constraints::EvaluationMode::SCORE_ONLY);
         return score;
     }
 
     template<typename X, typename Y, typename Z, typename W>
     class Evaluator {
     public:
-        explicit Evaluator(const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints) noexcept :
+        /**
+         * @param constraints Constraints to evaluate.
+         * @param mode Evaluation mode. In `EvaluationMode::SCORE_ONLY` mode violations are materialized on demand
+         *             (see `constraintScore` and `materializeViolations`).
+         */
+        explicit Evaluator(const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints,
+                           const ::Constraints::EvaluationMode mode = ::Constraints::EvaluationMode::FULL) noexcept :
             m_Constraints(constraints),
-            m_ConstraintScores(constraints.size(), ::Constraints::ConstraintScore{}) {
+            m_Mode(mode),
+            m_ConstraintScores(constraints.size(), ::Constraints::ConstraintScore{}),
+            m_PreviousConstraintScores(constraints.size(), ::Constraints::ConstraintScore{}),
+            m_PartitionTables(constraints.size()) {
+            for (size_t i = 0; i < constraints.size(); ++i)
+                m_PartitionTables[i].axis = constraints[i]->partitionAxis();
             #ifdef PRINT_CONSTRAINT_DEBUG_INFO
             m_ConstraintNameLength.reserve(constraints.size());
             for (auto *constraint : constraints) {
@@ -52,7 +66,39 @@ namespace Evaluation {
         Evaluator(const Evaluator&) noexcept = default;
 
         const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints() const noexcept { return m_Constraints; }
+        [[nodiscard]] ::Constraints::EvaluationMode mode() const noexcept { return m_Mode; }
+
+        /**
+         * Constraint scores of the last evaluation. Violations are only present for constraint scores that record
+         * them; use `constraintScore` if violations are needed.
+         */
         [[nodiscard]] const std::vector<::Constraints::ConstraintScore>& constraintScores() const noexcept { return m_ConstraintScores; }
+
+        /**
+         * Returns the score of the constraint at the given index with its violations materialized.
+         * @param index Constraint index.
+         * @param state State the constraint scores belong to (current candidate state).
+         * @return Constraint score with recorded violations.
+         */
+        [[nodiscard]] const ::Constraints::ConstraintScore& constraintScore(const size_t index, const ::State::State<X, Y, Z, W>& state) const noexcept {
+            auto& constraintScore = m_ConstraintScores[index];
+            if (!constraintScore.recordsViolations()) [[unlikely]] {
+                auto violations = m_Constraints[index]->evaluate(state, ::Constraints::EvaluationMode::FULL).violations();
+                m_TotalConstraintViolationCount += violations.size();
+                m_ViolatedConstraintCount += violations.size() > 0;
+                constraintScore = ::Constraints::ConstraintScore(constraintScore.score(), std::move(violations));
+            }
+            return constraintScore;
+        }
+
+        /**
+         * Materializes violations of all constraints, so that violation counts and `constraintScores` are complete.
+         * @param state State the constraint scores belong to (current candidate state).
+         */
+        void materializeViolations(const ::State::State<X, Y, Z, W>& state) const noexcept {
+            for (size_t i = 0; i < m_ConstraintScores.size(); ++i) (void) constraintScore(i, state);
+        }
+
         [[nodiscard]] size_t constraintCount() const noexcept { return m_Constraints.size(); }
         [[nodiscard]] size_t totalConstraintViolationCount() const noexcept { return m_TotalConstraintViolationCount; }
         [[nodiscard]] size_t violatedConstraintCount() const noexcept { return m_ViolatedConstraintCount; }
@@ -89,15 +135,50 @@ namespace Evaluation {
             #endif
         }
 
+        /**
+         * Evaluates the given candidate state from scratch. Must be followed by `commit` or `rollback`.
+         * @param state Candidate state.
+         * @return Total score of the candidate state.
+         */
         [[nodiscard]] Score::Score evaluateState(const ::State::State<X, Y, Z, W>& state) noexcept {
+            beginEvaluation(state, PendingEvaluation::FULL);
+
             Score::Score score {};
-            m_TotalConstraintViolationCount = 0;
-            m_ViolatedConstraintCount = 0;
+            size_t i = 0;
+            for (auto it = m_Constraints.begin(); it != m_Constraints.end(); ++it) {
+                const auto& constraint = *it;
+                auto constraintScore = constraint->evaluate(state, m_Mode);
+                score += constraintScore;
+                m_TotalConstraintViolationCount += constraintScore.violations().size();
+                m_ViolatedConstraintCount += constraintScore.violations().size() > 0;
+                m_ConstraintScores[i++] = std::move(constraintScore);
+            }
+
+            return score;
+        }
+
+        /**
+         * Evaluates the given candidate state incrementally relative to the last committed state. Falls back to
+         * `evaluateState` if nothing has been committed yet. Must be followed by `commit` or `rollback`.
+         * @param state Candidate state.
+         * @param changedLocations Locations that may have changed since the last committed state.
+         * @return Total score of the candidate state.
+         */
+        [[nodiscard]] Score::Score evaluateStateDelta(const ::State::State<X, Y, Z, W>& state,
+                                                      const std::vector<::State::Location>& changedLocations) noexcept {
+            if (!m_HasCommittedState) [[unlikely]] return evaluateState(state);
 
+            normalizeChanges(state, changedLocations);
+            beginEvaluation(state, PendingEvaluation::DELTA);
+
+            Score::Score score {};
             size_t i = 0;
             for (auto it = m_Constraints.begin(); it != m_Constraints.end(); ++it) {
                 const auto& constraint = *it;
-                const auto constraintScore = constraint->evaluate(state);
+                auto& partitionTable = m_PartitionTables[i];
+                auto constraintScore = partitionTable.axis != 0
+                                           ? evaluatePartitionsDelta(*constraint, partitionTable, state)
+                                           : constraint->evaluateDelta(state, m_FlippedLocations, m_Mode);
                 score += constraintScore;
                 m_TotalConstraintViolationCount += constraintScore.violations().size();
                 m_ViolatedConstraintCount += constraintScore.violations().size() > 0;
@@ -107,10 +188,193 @@ namespace Evaluation {
             return score;
         }
 
+        /**
+         * Accepts the last evaluated candidate state; it becomes the base for subsequent incremental evaluations.
+         */
+        void commit() noexcept {
+            switch (m_PendingEvaluation) {
+                case PendingEvaluation::FULL:
+                    for (size_t i = 0; i < m_Constraints.size(); ++i) {
+                        if (m_PartitionTables[i].axis != 0) resetPartitions(*m_Constraints[i], m_PartitionTables[i], *mp_PendingState);
+                        else m_Constraints[i]->resetDelta(*mp_PendingState);
+                    }
+                    m_CommittedBits = mp_PendingState->getBitArray();
+                    m_HasCommittedState = true;
+                    break;
+                case PendingEvaluation::DELTA:
+                    for (size_t i = 0; i < m_Constraints.size(); ++i) {
+                        if (m_PartitionTables[i].axis != 0) commitPartitions(m_PartitionTables[i]);
+                        else m_Constraints[i]->commitDelta();
+                    }
+                    for (const auto& location : m_FlippedLocations)
+                        m_CommittedBits.assign(location.index(mp_PendingState->size()), mp_PendingState->get(location));
+                    break;
+                case PendingEvaluation::NONE:
+                    break;
+            }
+            m_PendingEvaluation = PendingEvaluation::NONE;
+            mp_PendingState = nullptr;
+        }
+
+        /**
+         * Discards the last evaluated candidate state. Constraint scores are restored to the committed ones.
+         * The caller is responsible for reverting the state itself.
+         */
+        void rollback() noexcept {
+            if (m_PendingEvaluation == PendingEvaluation::NONE) return;
+            if (m_PendingEvaluation == PendingEvaluation::DELTA) {
+                for (size_t i = 0; i < m_Constraints.size(); ++i) {
+                    if (m_PartitionTables[i].axis != 0) m_PartitionTables[i].staged.clear();
+                    else m_Constraints[i]->rollbackDelta();
+                }
+            }
+            std::swap(m_ConstraintScores, m_PreviousConstraintScores);
+            m_TotalConstraintViolationCount = m_PreviousTotalConstraintViolationCount;
+            m_ViolatedConstraintCount = m_PreviousViolatedConstraintCount;
+            m_PendingEvaluation = PendingEvaluation::NONE;
+            mp_PendingState = nullptr;
+        }
+
     protected:
+        enum class PendingEvaluation : uint8_t {
+            NONE = 0,
+            FULL,
+            DELTA,
+        };
+
         const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& m_Constraints;
-        std::vector<::Constraints::ConstraintScore> m_ConstraintScores;
-        size_t m_TotalConstraintViolationCount{}, m_ViolatedConstraintCount{};
+        const ::Constraints::EvaluationMode m_Mode;
+        mutable std::vector<::Constraints::ConstraintScore> m_ConstraintScores;
+        mutable size_t m_TotalConstraintViolationCount{}, m_ViolatedConstraintCount{};
+
+        std::vector<::Constraints::ConstraintScore> m_PreviousConstraintScores;
+        size_t m_PreviousTotalConstraintViolationCount{}, m_PreviousViolatedConstraintCount{};
+
+        PendingEvaluation m_PendingEvaluation = PendingEvaluation::NONE;
+        const ::State::State<X, Y, Z, W> *mp_PendingState = nullptr;
+
+        /**
+         * Committed per-partition scores of a partitioned constraint (see `Constraint::partitionAxis`), with their
+         * violations in `EvaluationMode::FULL`. Partition scores of a candidate are staged until commit.
+         */
+        struct PartitionTable {
+            uint8_t axis = 0;
+            std::vector<::Constraints::ConstraintScore> scores;
+            Score::Score total {};
+            std::vector<std::pair<::State::axis_size_t, ::Constraints::ConstraintScore>> staged;
+            Score::Score stagedTotal {};
+        };
+
+        std::vector<PartitionTable> m_PartitionTables;
+        std::vector<uint32_t> m_PartitionMarks; // Per partition: 1 + index of its staged score, or 0 if not staged.
+
+        bool m_HasCommittedState = false;
+        BitArray::BitArray m_CommittedBits{0};
+        std::vector<::State::Location> m_FlippedLocations;
+        std::vector<std::pair<::State::state_size_t, ::State::Location>> m_IndexedChanges;
+
+        void beginEvaluation(const ::State::State<X, Y, Z, W>& state, const PendingEvaluation evaluation) noexcept {
+            // An evaluation that was neither committed nor rolled back is implicitly committed.
+            if (m_PendingEvaluation != PendingEvaluation::NONE) [[unlikely]] commit();
+            std::swap(m_ConstraintScores, m_PreviousConstraintScores);
+            m_PreviousTotalConstraintViolationCount = m_TotalConstraintViolationCount;
+            m_PreviousViolatedConstraintCount = m_ViolatedConstraintCount;
+            m_TotalConstraintViolationCount = 0;
+            m_ViolatedConstraintCount = 0;
+            m_PendingEvaluation = evaluation;
+            mp_PendingState = &state;
+        }
+
+        [[nodiscard]] static ::State::axis_size_t partitionOf(const ::State::Location& location, const uint8_t axis) noexcept {
+            switch (axis) {
+                case ::State::Area::X: return location.x;
+                case ::State::Area::Y: return location.y;
+                case ::State::Area::Z: return location.z;
+                default: return location.w;
+            }
+        }
+
+        [[nodiscard]] static ::State::axis_size_t partitionCount(const ::State::State<X, Y, Z, W>& state, const uint8_t axis) noexcept {
+            switch (axis) {
+                case ::State::Area::X: return state.sizeX();
+                case ::State::Area::Y: return state.sizeY();
+                case ::State::Area::Z: return state.sizeZ();
+                default: return state.sizeW();
+            }
+        }
+
+        void resetPartitions(::Constraints::Constraint<X, Y, Z, W>& constraint, PartitionTable& table,
+                             const ::State::State<X, Y, Z, W>& state) noexcept {
+            const auto count = partitionCount(state, table.axis);
+            table.scores.resize(count);
+            table.total = {};
+            table.staged.clear();
+            for (::State::axis_size_t p = 0; p < count; ++p) {
+                table.scores[p] = constraint.evaluatePartition(state, p, m_Mode);
+                table.total += table.scores[p];
+            }
+            if (m_PartitionMarks.size() < count) m_PartitionMarks.resize(count, 0);
+        }
+
+        /**
+         * Re-evaluates only the partitions touched by the flipped locations. In `EvaluationMode::FULL` the violations of
+         * the other partitions are taken from their committed scores.
+         */
+        [[nodiscard]] ::Constraints::ConstraintScore evaluatePartitionsDelta(::Constraints::Constraint<X, Y, Z, W>& constraint,
+                                                                             PartitionTable& table,
+                                                                             const ::State::State<X, Y, Z, W>& state) noexcept {
+            table.staged.clear();
+            table.stagedTotal = table.total;
+            for (const auto& location : m_FlippedLocations) {
+                const auto p = partitionOf(location, table.axis);
+                if (m_PartitionMarks[p]) continue;
+                auto score = constraint.evaluatePartition(state, p, m_Mode);
+                table.stagedTotal += score.score() - table.scores[p].score();
+                table.staged.emplace_back(p, std::move(score));
+                m_PartitionMarks[p] = static_cast<uint32_t>(table.staged.size());
+            }
+
+            ::Constraints::ConstraintScore constraintScore(m_Mode);
+            if (m_Mode == ::Constraints::EvaluationMode::FULL) {
+                std::vector<::Constraints::Violation> violations;
+                for (::State::axis_size_t p = 0; p < table.scores.size(); ++p) {
+                    const auto& partition = m_PartitionMarks[p] ? table.staged[m_PartitionMarks[p] - 1].second : table.scores[p];
+                    violations.insert(violations.end(), partition.violations().begin(), partition.violations().end());
+                }
+                constraintScore = ::Constraints::ConstraintScore(table.stagedTotal, std::move(violations));
+            } else {
+                constraintScore += table.stagedTotal;
+            }
+            for (const auto& [p, score] : table.staged) m_PartitionMarks[p] = 0;
+            return constraintScore;
+        }
+
+        static void commitPartitions(PartitionTable& table) noexcept {
+            for (auto& [p, score] : table.staged) table.scores[p] = std::move(score);
+            table.total = table.stagedTotal;
+            table.staged.clear();
+        }
+
+        /**
+         * Reduces a change set to distinct locations whose values differ from the committed state.
+         */
+        void normalizeChanges(const ::State::State<X, Y, Z, W>& state,
+                              const std::vector<::State::Location>& changedLocations) noexcept {
+            m_IndexedChanges.clear();
+            m_IndexedChanges.reserve(changedLocations.size());
+            for (const auto& location : changedLocations) {
+                if (!state.hasConcept(location.x, location.w)) [[unlikely]] continue; // Not stored by a compressed state
+                m_IndexedChanges.emplace_back(location.index(state.size()), location);
+            }
+            std::ranges::sort(m_IndexedChanges, {}, &std::pair<::State::state_size_t, ::State::Location>::first);
+
+            m_FlippedLocations.clear();
+            for (size_t i = 0; i < m_IndexedChanges.size(); ++i) {
+                const auto& [index, location] = m_IndexedChanges[i];
+                if (i > 0 && m_IndexedChanges[i - 1].first == index) continue;
+                if (state.get(location) != m_CommittedBits.get(index)) m_FlippedLocations.push_back(location);
+            }
+        }
 
         friend class ::Heuristics::HeuristicProvider<X, Y, Z, W>;
 
@@ -0,0 +1,172 @@
+#ifndef BESTIMPROVEMENTLOCALSEARCHTASK_H
+#define BESTIMPROVEMENTLOCALSEARCHTASK_H
+
+#include "Search/LocalSearchTask.h"
+#include "Moves/AssignmentCandidates.h"
+#include "Moves/FlipList.h"
+
+#include "Utils/Random.h"
+
+#include <vector>
+
+namespace Search::Task {
+    /**
+     * Best-improvement descent over a small neighborhood per step: all toggles of one (y, z) cell, or all transfers of
+     * the assignments of one (x, z) to another Y, restricted to eligible assignments (see `AssignmentCandidates`).
+     * Every candidate is scored by delta evaluation inside a state transaction that is rolled back, then the best one
+     * is applied if it doesn't worsen the current score (ties are broken at random, so plateaus are crossed).
+     */
+    template<typename X, typename Y, typename Z, typename W>
+    class BestImprovementLocalSearchTask : public LocalSearchTask<X, Y, Z, W> {
+        using Base = LocalSearchTask<X, Y, Z, W>;
+        using Move = ::Moves::FlipList<2>;
+    public:
+        struct Params {
+            uint32_t transferNeighborhoodPercentage = 50; // Chance of scanning transfers instead of toggles
+            int maxIdleIterationCount = 20000;
+            int iterAtZeroThreshold = 200;
+            int iterAtFeasibleThreshold = 400;
+            int maxFeasibleIdleIterationCount = 300;
+        };
+        BestImprovementLocalSearchTask(const BestImprovementLocalSearchTask&) = delete;
+
+        // ReSharper disable CppRedundantQualifier
+        explicit BestImprovementLocalSearchTask(const ::State::State<X, Y, Z, W> inputState,
+                                                const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints,
+                                                Statistics::ScoreStatistics& scoreStatistics,
+                                                const Params& params = Params{}) noexcept
+            : Base(inputState, constraints, scoreStatistics), m_Params(params) { }
+        // ReSharper restore CppRedundantQualifier
+
+        ~BestImprovementLocalSearchTask() noexcept override = default;
+
+        // ReSharper disable once CppRedundantQualifier
+        void reset(const ::State::State<X, Y, Z, W> inputState) noexcept override {
+            Base::reset(inputState);
+            m_Iterations = 0;
+            m_IdleIterations = 0;
+            m_IterationCountAtZeroScore = 0;
+            m_IterationCountAtFeasibleScore = 0;
+        }
+
+        void setParams(const Params& params) noexcept { m_Params = params; }
+
+        // ReSharper disable CppRedundantQualifier
+        void step(::Heuristics::HeuristicProvider<X, Y, Z, W>& heuristicProvider) noexcept override {
+            Base::m_NewBestFound = false;
+
+            const ::State::State<X, Y, Z, W>& state = Base::m_CurrentState;
+            const auto& eligible = heuristicProvider.assignmentCandidates();
+            const ::State::axis_size_t z = m_Random.randomInt(state.sizeZ() - 1);
+            m_Candidates.clear();
+            if (m_Random.randomInt(0, 99) < m_Params.transferNeighborhoodPercentage)
+                collectTransfers(state, eligible, m_Random.randomInt(state.sizeX() - 1), z);
+            if (m_Candidates.empty()) collectToggles(state, eligible, m_Random.randomInt(state.sizeY() - 1), z);
+
+            // Score every candidate against the current state; ties with the best are sampled uniformly. A candidate
+            // is only rejected when the next one is scored, so the last one is still applied and evaluated afterward.
+            size_t best = m_Candidates.size();
+            Score::Score bestScore {};
+            uint32_t ties = 0;
+            for (size_t i = 0; i < m_Candidates.size(); ++i) {
+                if (i > 0) Base::rejectCandidate();
+                Base::beginCandidate();
+                m_Candidates[i].apply(Base::m_CurrentState);
+                const Score::Score score = Base::evaluateCandidate();
+                if (best == m_Candidates.size() || score > bestScore) {
+                    best = i;
+                    bestScore = score;
+                    ties = 1;
+                } else if (score == bestScore && m_Random.randomInt(0, ties++) == 0) {
+                    best = i;
+                }
+            }
+
+            if (best == m_Candidates.size() || bestScore <= Base::m_CurrentScore) { m_IdleIterations++; } else { m_IdleIterations = 0; }
+
+            if (best != m_Candidates.size() && bestScore < Base::m_CurrentScore) Base::rejectCandidate();
+            if (best != m_Candidates.size() && bestScore >= Base::m_CurrentScore) {
+                // Constraints stage a single candidate, so the winner is evaluated again unless it was scored last
+                if (best != m_Candidates.size() - 1) {
+                    Base::rejectCandidate();
+                    Base::beginCandidate();
+                    m_Candidates[best].apply(Base::m_CurrentState);
+                    (void) Base::evaluateCandidate();
+                }
+                Base::m_CurrentScore = bestScore;
+                Base::acceptCandidate();
+
+                if (Base::m_CurrentScore > Base::m_OutputScore) {
+                    Base::m_OutputScore = Base::m_CurrentScore;
+                    Base::recordBest();
+                    Base::m_NewBestFound = true;
+                    Base::m_ScoreStatistics.record(Base::m_CurrentScore);
+                }
+            }
+
+            ++m_Iterations;
+        }
+        // ReSharper restore CppRedundantQualifier
+
+        [[nodiscard]] bool shouldStep() noexcept override {
+            if (Base::m_OutputScore.isZero()) [[unlikely]] {
+                if (m_IterationCountAtZeroScore >= static_cast<uint64_t>(m_Params.iterAtZeroThreshold)) [[unlikely]] return m_IdleIterations < static_cast<uint64_t>(m_Params.maxFeasibleIdleIterationCount) >> 1;
+                m_IterationCountAtZeroScore += 1;
+                return true;
+            }
+            if (Base::m_OutputScore.isFeasible()) [[unlikely]] {
+                if (m_IterationCountAtFeasibleScore >= static_cast<uint64_t>(m_Params.iterAtFeasibleThreshold)) [[unlikely]] return m_IdleIterations < static_cast<uint64_t>(m_Params.maxFeasibleIdleIterationCount);
+                m_IterationCountAtFeasibleScore += 1;
+                return true;
+            }
+            return m_IdleIterations < static_cast<uint64_t>(m_Params.maxIdleIterationCount);
+        }
+
+    private:
+        inline static Random::RandomGenerator& m_Random = Random::generator();
+
+        uint64_t m_IterationCountAtZeroScore = 0, m_IterationCountAtFeasibleScore = 0;
+
+        uint64_t m_Iterations = 0;
+        uint64_t m_IdleIterations = 0;
+
+        Params m_Params{};
+        std::vector<Move> m_Candidates; // Neighborhood of the current step; the buffer is reused.
+
+        /**
+         * Every toggle of an eligible (x, w) of cell (`y`, `z`), and the removal of its assignments that aren't eligible.
+         */
+        void collectToggles(const ::State::State<X, Y, Z, W>& state, const ::Moves::AssignmentCandidates& eligible,
+                            const ::State::axis_size_t y, const ::State::axis_size_t z) noexcept {
+            for (const auto& cell : eligible.cells(y, z)) {
+                Move& move = m_Candidates.emplace_back();
+                move.reset(state.size());
+                move.flip(::State::Location {cell.x, y, z, cell.w});
+            }
+            for (const auto& assigned : state.setLocations(::State::ANY, y, z)) {
+                if (eligible.isEligible(assigned)) continue;
+                Move& move = m_Candidates.emplace_back();
+                move.reset(state.size());
+                move.flip(assigned);
+            }
+        }
+
+        /**
+         * Every transfer of an assignment at (`x`, `z`) to another Y for which it is eligible and not assigned yet.
+         */
+        void collectTransfers(const ::State::State<X, Y, Z, W>& state, const ::Moves::AssignmentCandidates& eligible,
+                              const ::State::axis_size_t x, const ::State::axis_size_t z) noexcept {
+            for (const auto& from : state.setLocations(x, ::State::ANY, z)) {
+                for (const auto& [y, w] : eligible.pairs(x, z)) {
+                    if (w != from.w || y == from.y || state.get(x, y, z, w)) continue;
+                    Move& move = m_Candidates.emplace_back();
+                    move.reset(state.size());
+                    move.flip(from);
+                    move.flip(from.withY(y));
+                }
+            }
+        }
+    };
+}
+
+#endif //BESTIMPROVEMENTLOCALSEARCHTASK_H
@@ -61,8 +61,9 @@ namespace Search::Task {
             // Generate new candidate solution
             ::State::State<X, Y, Z, W>& candidateState = Base::m_CurrentState;
             auto perturbators = heuristicProvider.generateSearchPerturbators(Base::m_Evaluator, candidateState);
+            Base::beginCandidate();
             perturbators.modify(candidateState);
-            const Score::Score candidateScore = Base::m_Evaluator.evaluateState(candidateState);
+            const Score::Score candidateScore = Base::evaluateCandidate();
 
             // Track idle iterations (termination criteria)
             if (candidateScore <= Base::m_CurrentScore) { m_IdleIterations++; } else { m_IdleIterations = 0; }
@@ -76,12 +77,13 @@ namespace Search::Task {
                 // Accept candidate
                 // `m_CurrentState = candidateState` assignment is not needed, because `candidateState` is a reference
                 // to "working memory" `m_CurrentState`. But we need to update the score.
+                Base::acceptCandidate();
                 Base::m_CurrentScore = candidateScore;
 
                 if (Base::m_CurrentScore > Base::m_OutputScore) {
                     // New best state found
                     Base::m_OutputScore = Base::m_CurrentScore;
-                    Base::m_OutputState = Base::m_CurrentState;
+                    Base::recordBest();
                     Base::m_NewBestFound = true;
                     Base::m_ScoreStatistics.record(Base::m_CurrentScore);
 
@@ -110,7 +112,7 @@ namespace Search::Task {
                 // std::cout << "Applied perturbators size: " << m_AppliedPerturbators.size() << ", best score achieved before " << m_BestScoreAchievedBeforePerturbationCount << " perturbations; idle iteration count: " << m_IdleIterations << std::endl;
             } else {
                 // Revert candidate
-                perturbators.revert(candidateState);
+                Base::rejectCandidate();
             }
 
             ++m_Iterations;
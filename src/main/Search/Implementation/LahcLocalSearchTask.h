@@ -65,8 +65,9 @@ namespace Search::Task {
             //     m_AppliedPerturbators.append(repairPerturbators);
             //     std::cout << "Applying repair perturbators" << std::endl;
             // }
+            Base::beginCandidate();
             perturbators.modify(candidateState);
-            const Score::Score candidateScore = Base::m_Evaluator.evaluateState(candidateState);
+            const Score::Score candidateScore = Base::evaluateCandidate();
 
             // Track idle iterations (termination criteria)
             if (candidateScore <= Base::m_CurrentScore) { m_IdleIterations++; } else { m_IdleIterations = 0; }
@@ -79,13 +80,14 @@ namespace Search::Task {
             if (candidateScore > fv || candidateScore >= Base::m_CurrentScore) {
                 // `m_CurrentState = candidateState` assignment is not needed, because `candidateState` is a reference
                 // to "working memory" `m_CurrentState`. But we need to update the score.
+                Base::acceptCandidate();
                 Base::m_CurrentScore = candidateScore;
 
                 if (Base::m_CurrentScore > Base::m_OutputScore) {
                     // The new best state is found.
                     // It is already updated as the current "working memory" `m_CurrentState`.
                     Base::m_OutputScore = Base::m_CurrentScore;
-                    Base::m_OutputState = Base::m_CurrentState;
+                    Base::recordBest();
                     Base::m_NewBestFound = true;
 
                     // Record score statistics
@@ -107,7 +109,7 @@ namespace Search::Task {
             } else {
                 // Revert the new candidate state to the previous candidate state,
                 // because the new candidate state references the "working memory" `m_CurrentState`.
-                perturbators.revert(candidateState);
+                Base::rejectCandidate();
             }
 
             // Update history
@@ -77,14 +77,15 @@ namespace Search::Task {
             );
 
             ::Heuristics::PerturbatorChain<X, Y, Z, W> compoundPerturbators{};
+            Base::beginCandidate();
             for (uint32_t i = 0; i < movesThisStep; ++i) {
                 auto chain = heuristicProvider.generateSearchPerturbators(Base::m_Evaluator, candidateState);
                 if (!chain.empty()) {
-                    compoundPerturbators.append(chain);
                     chain.modify(candidateState);
+                    compoundPerturbators.append(chain);
                 }
             }
-            const Score::Score candidateScore = Base::m_Evaluator.evaluateState(candidateState);
+            const Score::Score candidateScore = Base::evaluateCandidate();
 
             if (candidateScore <= Base::m_CurrentScore) { m_IdleIterations++; } else { m_IdleIterations = 0; }
 
@@ -153,18 +154,19 @@ namespace Search::Task {
             }
 
             if (accept) {
+                Base::acceptCandidate();
                 Base::m_CurrentScore = candidateScore;
 
                 if (Base::m_CurrentScore > Base::m_OutputScore) {
                     Base::m_OutputScore = Base::m_CurrentScore;
-                    Base::m_OutputState = Base::m_CurrentState;
+                    Base::recordBest();
                     Base::m_NewBestFound = true;
                     Base::m_ScoreStatistics.record(Base::m_CurrentScore);
                 }
 
                 // m_AppliedPerturbators.append(compoundPerturbators);
             } else {
-                compoundPerturbators.revert(candidateState);
+                Base::rejectCandidate();
             }
 
             coolDown();
@@ -2,7 +2,6 @@
 #define TABUMOVELOCALSEARCHTASK_H
 
 #include "Search/LocalSearchTask.h"
-#include "Array/BitArray.h"
 
 #include <unordered_map>
 #include <deque>
@@ -25,7 +24,9 @@ namespace Search::Task {
                                          const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints,
                                          Statistics::ScoreStatistics& scoreStatistics,
                                          const Params& params = Params{}) noexcept
-                : Base(inputState, constraints, scoreStatistics), m_Params(params), m_TabuTenure(params.tabuTenure) { }
+                : Base(inputState, constraints, scoreStatistics), m_Params(params), m_TabuTenure(params.tabuTenure) {
+            Base::m_CurrentState.trackHash(true);
+        }
 
         ~TabuMoveLocalSearchTask() noexcept override = default;
 
@@ -51,16 +52,14 @@ namespace Search::Task {
             ::State::State<X, Y, Z, W>& candidateState = Base::m_CurrentState;
             auto perturbators = heuristicProvider.generateSearchPerturbators(Base::m_Evaluator, candidateState);
 
-            // Snapshot previous bit-array to compute changed positions
-            const auto& prevBits = candidateState.getBitArray();
-            BitArray::BitArray prevSnapshot(prevBits);
-
             // Apply move to get candidate
+            const uint64_t previousHash = candidateState.hash();
+            Base::beginCandidate();
             perturbators.modify(candidateState);
 
-            // Compute move signature from bit differences (attribute-level)
-            const uint64_t moveSig = computeMoveSignature(prevSnapshot, candidateState.getBitArray());
-            const Score::Score candidateScore = Base::m_Evaluator.evaluateState(candidateState);
+            // The move signature (attribute-level) is the XOR of the Zobrist keys of the toggled bits
+            const uint64_t moveSig = previousHash ^ candidateState.hash();
+            const Score::Score candidateScore = Base::evaluateCandidate();
 
             if (candidateScore <= Base::m_CurrentScore) { m_IdleIterations++; } else { m_IdleIterations = 0; }
 
@@ -75,17 +74,18 @@ namespace Search::Task {
             }
 
             if (accept) {
+                Base::acceptCandidate();
                 Base::m_CurrentScore = candidateScore;
                 if (Base::m_CurrentScore > Base::m_OutputScore) {
                     Base::m_OutputScore = Base::m_CurrentScore;
-                    Base::m_OutputState = Base::m_CurrentState;
+                    Base::recordBest();
                     Base::m_NewBestFound = true;
                     Base::m_ScoreStatistics.record(Base::m_CurrentScore);
                 }
                 // m_AppliedPerturbators.append(perturbators);
                 pushTabu(moveSig);
             } else {
-                perturbators.revert(candidateState);
+                Base::rejectCandidate();
             }
 
             ++m_Iterations;
@@ -118,26 +118,6 @@ namespace Search::Task {
 
         // ::Heuristics::PerturbatorChain<X, Y, Z, W> m_AppliedPerturbators{};
 
-        static uint64_t rotl(const uint64_t x, const uint8_t r) noexcept {
-            return (x << r) | (x >> (64 - r));
-        }
-
-        [[nodiscard]] uint64_t computeMoveSignature(const BitArray::BitArray& before,
-                                                    const BitArray::BitArray& after) const noexcept {
-            const BitArray::array_size_t size = before.size();
-            uint64_t h = 1469598103934665603ULL; // FNV offset basis
-            for (BitArray::array_size_t i = 0; i < size; i += 64) {
-                const uint64_t bw = before.word(i);
-                const uint64_t aw = after.word(i);
-                const uint64_t delta = bw ^ aw; // toggled bits
-                if (delta == 0ULL) continue;
-                h ^= delta; h *= 1099511628211ULL; h = rotl(h, 13);
-            }
-            // Also mix count of changed bits for extra discrimination
-            h ^= after.count() - before.count();
-            return h;
-        }
-
         void pushTabu(const uint64_t sig) noexcept {
             m_TabuQueue.push_back(sig);
             m_TabuMap[sig] += 1;
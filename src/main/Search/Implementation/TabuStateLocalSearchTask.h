@@ -2,7 +2,6 @@
 #define TABUSTATELOCALSEARCHTASK_H
 
 #include "Search/LocalSearchTask.h"
-#include "Array/BitArray.h"
 
 #include <unordered_set>
 #include <deque>
@@ -26,7 +25,9 @@ namespace Search::Task {
                                      const std::vector<::Constraints::Constraint<X, Y, Z, W> *>& constraints,
                                      Statistics::ScoreStatistics& scoreStatistics,
                                      const Params& params = Params{}) noexcept
-                : Base(inputState, constraints, scoreStatistics), m_Params(params), m_TabuTenure(params.tabuTenure) { }
+                : Base(inputState, constraints, scoreStatistics), m_Params(params), m_TabuTenure(params.tabuTenure) {
+            Base::m_CurrentState.trackHash(true);
+        }
 
         ~TabuStateLocalSearchTask() noexcept override = default;
 
@@ -52,14 +53,15 @@ namespace Search::Task {
             // Generate new candidate solution
             ::State::State<X, Y, Z, W>& candidateState = Base::m_CurrentState;
             auto perturbators = heuristicProvider.generateSearchPerturbators(Base::m_Evaluator, candidateState);
+            Base::beginCandidate();
             perturbators.modify(candidateState);
-            const Score::Score candidateScore = Base::m_Evaluator.evaluateState(candidateState);
+            const Score::Score candidateScore = Base::evaluateCandidate();
 
             // Track idle iterations (termination criteria)
             if (candidateScore <= Base::m_CurrentScore) { m_IdleIterations++; } else { m_IdleIterations = 0; }
 
-            // Compute state hash for tabu check
-            const uint64_t candidateHash = computeStateHash(candidateState);
+            // The candidate's hash is maintained incrementally by the state
+            const uint64_t candidateHash = candidateState.hash();
             const bool isTabu = m_TabuSet.contains(candidateHash);
             const bool aspiration = candidateScore > Base::m_OutputScore;
 
@@ -73,11 +75,12 @@ namespace Search::Task {
             }
 
             if (accept) {
+                Base::acceptCandidate();
                 Base::m_CurrentScore = candidateScore;
 
                 if (Base::m_CurrentScore > Base::m_OutputScore) {
                     Base::m_OutputScore = Base::m_CurrentScore;
-                    Base::m_OutputState = Base::m_CurrentState;
+                    Base::recordBest();
                     Base::m_NewBestFound = true;
                     Base::m_ScoreStatistics.record(Base::m_CurrentScore);
                 }
@@ -86,7 +89,7 @@ namespace Search::Task {
                 pushTabu(candidateHash);
             } else {
                 // Revert the candidate state
-                perturbators.revert(candidateState);
+                Base::rejectCandidate();
             }
 
             ++m_Iterations;
@@ -119,25 +122,6 @@ namespace Search::Task {
 
         // ::Heuristics::PerturbatorChain<X, Y, Z, W> m_AppliedPerturbators{};
 
-        static uint64_t rotl(const uint64_t x, const uint8_t r) noexcept {
-            return (x << r) | (x >> (64 - r));
-        }
-
-        [[nodiscard]] uint64_t computeStateHash(const ::State::State<X, Y, Z, W>& state) const noexcept {
-            const auto& bits = state.getBitArray();
-            const BitArray::array_size_t size = bits.size();
-            uint64_t h = 1469598103934665603ULL; // FNV offset basis
-            for (BitArray::array_size_t i = 0; i < size; i += 64) {
-                const uint64_t w = bits.word(i);
-                h ^= w;
-                h *= 1099511628211ULL; // FNV prime
-                h = rotl(h, 13);
-            }
-            // Mix in size to avoid collisions for different sizes
-            h ^= size + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
-            return h;
-        }
-
         void pushTabu(const uint64_t hash) noexcept {
             m_TabuQueue.push_back(hash);
             m_TabuSet.insert(hash);
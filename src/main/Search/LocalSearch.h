@@ -15,12 +15,13 @@
 #include "Search/Implementation/SaLocalSearchTask.h"
 #include "Search/Implementation/TabuStateLocalSearchTask.h"
 #include "Search/Implementation/TabuMoveLocalSearchTask.h"
+#include "Search/Implementation/BestImprovementLocalSearchTask.h"
 
 namespace Search {
-    enum class LocalSearchType { LAHC = 0, DLAS, SA, TABU_STATE, TABU_MOVE, __COUNT };
+    enum class LocalSearchType { LAHC = 0, DLAS, SA, TABU_STATE, TABU_MOVE, BEST_IMPROVEMENT, __COUNT };
 
     constexpr std::array<std::string_view, static_cast<size_t>(LocalSearchType::__COUNT)> LocalSearchTypeNames = {
-        "LAHC", "DLAS", "SA", "TABU_STATE", "TABU_MOVE"
+        "LAHC", "DLAS", "SA", "TABU_STATE", "TABU_MOVE", "BEST_IMPROVEMENT"
     };
 
     constexpr std::string_view LocalSearchTypeName(const LocalSearchType type) {
@@ -60,6 +61,10 @@ namespace Search {
                     mp_Task = new Task::TabuMoveLocalSearchTask<X, Y, Z,
                         W>(*initialState, m_Constraints, m_ScoreStatistics);
                     break;
+                case LocalSearchType::BEST_IMPROVEMENT:
+                    mp_Task = new Task::BestImprovementLocalSearchTask<X, Y, Z,
+                        W>(*initialState, m_Constraints, m_ScoreStatistics);
+                    break;
                 default:
                     mp_Task = new Task::DlasLocalSearchTask<X, Y, Z,
                         W>(*initialState, m_Constraints, m_ScoreStatistics);
@@ -170,6 +175,12 @@ namespace Search {
             }
         }
 
+        void configureBestImprovement(const Task::BestImprovementLocalSearchTask<X, Y, Z, W>::Params& params) noexcept {
+            if (auto* bi = dynamic_cast<Task::BestImprovementLocalSearchTask<X, Y, Z, W>*>(mp_Task)) {
+                bi->setParams(params);
+            }
+        }
+
         [[nodiscard]] bool durationTerminationCriteriaIsIgnored() const noexcept {
             return m_MaxDurationInSeconds == 0;
         }
@@ -206,7 +217,7 @@ namespace Search {
             Score::Score score{};
             // ReSharper disable once CppRedundantQualifier
             for (::Constraints::Constraint<X, Y, Z, W>* constraint: m_Constraints)
-                score += constraint->evaluate(mp_Task->getOutputState());
+                score += constraint->evaluate(mp_Task->getOutputState(), ::Constraints::EvaluationMode::SCORE_ONLY);
             return score;
         }
 
@@ -6,8 +6,13 @@
 #include "Constraints/Constraint.h"
 #include "Score/Score.h"
 #include "Heuristics/HeuristicProvider.h"
+#include "Moves/PerturbatorChain.h"
 #include "Statistics/ScoreStatistics.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace Search::Task {
     template<typename X, typename Y, typename Z, typename W>
     class LocalSearchTask {
@@ -19,10 +24,11 @@ namespace Search::Task {
                                  const std::vector<::Constraints::Constraint<X, Y, Z, W> *> &constraints,
                                  Statistics::ScoreStatistics &scoreStatistics) noexcept :
             m_OutputState(inputState),
-            m_Evaluator(constraints),
+            m_Evaluator(constraints, ::Constraints::EvaluationMode::SCORE_ONLY),
             m_ScoreStatistics(scoreStatistics),
-            m_InitScore(Evaluation::evaluateState(inputState, constraints)),
+            m_InitScore(m_Evaluator.evaluateState(inputState)),
             m_CurrentState(inputState) {
+            m_Evaluator.commit();
             m_CurrentScore = m_InitScore;
             m_OutputScore = m_InitScore;
         }
@@ -33,7 +39,12 @@ namespace Search::Task {
         [[nodiscard]] bool newBestFound() const noexcept { return m_NewBestFound; }
 
         // ReSharper disable once CppRedundantQualifier
-        virtual void reset(const ::State::State<X, Y, Z, W> inputState) noexcept { m_OutputState = inputState; }
+        virtual void reset(const ::State::State<X, Y, Z, W> inputState) noexcept {
+            m_OutputState = inputState;
+            m_OutputJournal.clear();
+            m_BestJournalSize = 0;
+            m_OutputJournalValid = false; // `m_CurrentState` is not reset, so the journal no longer leads to it
+        }
 
         // ReSharper disable CppRedundantQualifier
         virtual void step(::Heuristics::HeuristicProvider<X, Y, Z, W> &heuristicProvider) noexcept = 0;
@@ -48,12 +59,15 @@ namespace Search::Task {
         [[nodiscard]] Score::Score getInitialScore() const noexcept { return m_InitScore; }
 
         // ReSharper disable once CppRedundantQualifier
-        [[nodiscard]] ::State::State<X, Y, Z, W> getOutputState() const noexcept { return m_OutputState; }
+        [[nodiscard]] const ::State::State<X, Y, Z, W>& getOutputState() const noexcept {
+            materializeOutputState();
+            return m_OutputState;
+        }
         [[nodiscard]] Score::Score getOutputScore() const noexcept { return m_OutputScore; }
 
     protected:
         // ReSharper disable once CppRedundantQualifier
-        ::State::State<X, Y, Z, W> m_OutputState;
+        mutable ::State::State<X, Y, Z, W> m_OutputState; // Best state up to the journal, see `recordBest`.
         Score::Score m_OutputScore;
         Evaluation::Evaluator<X, Y, Z, W> m_Evaluator;
         Statistics::ScoreStatistics& m_ScoreStatistics;
@@ -64,6 +78,85 @@ namespace Search::Task {
         Score::Score m_CurrentScore;
 
         bool m_NewBestFound = false;
+
+        /**
+         * Starts a candidate: writes to `m_CurrentState` from here on are journaled until it is accepted or rejected.
+         */
+        void beginCandidate() noexcept { m_CurrentState.begin(); }
+
+        /**
+         * Evaluates `m_CurrentState` incrementally from the writes made since `beginCandidate`.
+         * @return Candidate score.
+         */
+        [[nodiscard]] Score::Score evaluateCandidate() noexcept {
+            m_ChangedLocations.clear();
+            m_CurrentState.collectChangedLocations(m_ChangedLocations);
+            return m_Evaluator.evaluateStateDelta(m_CurrentState, m_ChangedLocations);
+        }
+
+        /**
+         * Accepts the last evaluated candidate.
+         */
+        void acceptCandidate() noexcept {
+            m_CurrentState.commit();
+            m_Evaluator.commit();
+            if (!m_OutputJournalValid) return;
+            for (const auto& location : m_ChangedLocations) m_OutputJournal.emplace_back(location, m_CurrentState.get(location));
+            if (m_OutputJournal.size() > maxJournalSize()) {
+                materializeOutputState();
+                if (m_OutputJournal.size() > maxJournalSize()) {
+                    m_OutputJournal.clear();
+                    m_OutputJournalValid = false;
+                }
+            }
+        }
+
+        /**
+         * Records `m_CurrentState` as the new best state. Instead of copying the state, the journal position is
+         * remembered and the output state is brought up to it on demand.
+         */
+        void recordBest() noexcept {
+            if (m_OutputJournalValid) {
+                m_BestJournalSize = m_OutputJournal.size();
+                return;
+            }
+            m_OutputState = m_CurrentState;
+            m_OutputJournal.clear();
+            m_BestJournalSize = 0;
+            m_OutputJournalValid = true;
+        }
+
+        /**
+         * Rejects the last evaluated candidate and reverts `m_CurrentState`.
+         */
+        void rejectCandidate() noexcept {
+            m_CurrentState.rollback();
+            m_Evaluator.rollback();
+        }
+
+    private:
+        std::vector<::State::Location> m_ChangedLocations;
+
+        // Values written to `m_CurrentState` by accepted candidates since `m_OutputState` was last brought up to date.
+        // While valid, `m_OutputState` + the first `m_BestJournalSize` entries is the best state and `m_OutputState` +
+        // all entries is the current state.
+        mutable std::vector<std::pair<::State::Location, uint8_t>> m_OutputJournal;
+        mutable size_t m_BestJournalSize = 0;
+        bool m_OutputJournalValid = true;
+
+        /**
+         * Replaying this many writes costs about as much as copying the state.
+         */
+        [[nodiscard]] size_t maxJournalSize() const noexcept {
+            return std::max<size_t>(256, m_CurrentState.flatSize() / 64);
+        }
+
+        void materializeOutputState() const noexcept {
+            if (m_BestJournalSize == 0) return;
+            for (size_t i = 0; i < m_BestJournalSize; ++i) m_OutputState.assign(m_OutputJournal[i].first, m_OutputJournal[i].second);
+            m_OutputJournal.erase(m_OutputJournal.begin(), m_OutputJournal.begin() + static_cast<std::ptrdiff_t>(m_BestJournalSize));
+            m_BestJournalSize = 0;
+        }
     };
 }
 
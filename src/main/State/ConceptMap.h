@@ -0,0 +1,74 @@
+#ifndef CONCEPTMAP_H
+#define CONCEPTMAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace State {
+    typedef uint32_t axis_size_t;
+
+    /**
+     * Valid concepts (W) of every X of a compressed state.<br>
+     * A compressed state stores `slots()` bits per (x, y, z) cell instead of one per concept, where `slots()` is the
+     * largest number of valid concepts of any X; the concepts of an X occupy its slots in increasing order. Concepts
+     * that are not valid for an X are structurally unassigned.
+     */
+    class ConceptMap {
+    public:
+        static constexpr axis_size_t NONE = std::numeric_limits<axis_size_t>::max();
+
+        /**
+         * @param validConcepts Valid concepts of every X.
+         * @param concepts Size of the W axis.
+         */
+        ConceptMap(const std::vector<std::vector<axis_size_t>>& validConcepts, const axis_size_t concepts) noexcept :
+            m_Width(static_cast<axis_size_t>(validConcepts.size())),
+            m_Concepts(concepts),
+            m_Slots(1),
+            m_SlotOf(static_cast<size_t>(m_Width) * concepts, NONE) {
+            for (const auto& valid : validConcepts) m_Slots = std::max(m_Slots, static_cast<axis_size_t>(valid.size()));
+            m_ConceptOf.assign(static_cast<size_t>(m_Width) * m_Slots, NONE);
+            for (axis_size_t x = 0; x < m_Width; ++x) {
+                std::vector<axis_size_t> valid = validConcepts[x];
+                std::ranges::sort(valid);
+                for (axis_size_t slot = 0; slot < valid.size(); ++slot) {
+                    assert(valid[slot] < concepts && "Concept out of bounds.");
+                    m_SlotOf[x * m_Concepts + valid[slot]] = slot;
+                    m_ConceptOf[x * m_Slots + slot] = valid[slot];
+                }
+            }
+        }
+
+        [[nodiscard]] constexpr axis_size_t width() const noexcept { return m_Width; }
+        [[nodiscard]] constexpr axis_size_t concepts() const noexcept { return m_Concepts; }
+        [[nodiscard]] constexpr axis_size_t slots() const noexcept { return m_Slots; }
+
+        /**
+         * @return Slot of concept `w` in the cells of `x`, or `NONE` if it is not valid for `x`.
+         */
+        [[nodiscard]] constexpr axis_size_t slot(const axis_size_t x, const axis_size_t w) const noexcept {
+            return m_SlotOf[x * m_Concepts + w];
+        }
+
+        /**
+         * @return Concept stored in `slot` of the cells of `x`, or `NONE` for a padding slot.
+         */
+        [[nodiscard]] constexpr axis_size_t conceptAt(const axis_size_t x, const axis_size_t slot) const noexcept {
+            return m_ConceptOf[x * m_Slots + slot];
+        }
+
+        [[nodiscard]] constexpr bool isValid(const axis_size_t x, const axis_size_t w) const noexcept { return slot(x, w) != NONE; }
+
+    private:
+        axis_size_t m_Width;
+        axis_size_t m_Concepts;
+        axis_size_t m_Slots;
+        std::vector<axis_size_t> m_SlotOf; // Per (x, w).
+        std::vector<axis_size_t> m_ConceptOf; // Per (x, slot).
+    };
+}
+
+#endif //CONCEPTMAP_H
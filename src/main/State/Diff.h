@@ -0,0 +1,130 @@
+#ifndef DIFF_H
+#define DIFF_H
+
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "State/Size.h"
+#include "State/Location.h"
+
+#include "Array/BitArray.h"
+
+namespace State {
+    /**
+     * Half-open range of word indices.
+     */
+    struct WordRange {
+        BitArray::array_size_t begin;
+        BitArray::array_size_t end;
+    };
+
+    /**
+     * Difference between two states of the same size and layout, as maximal runs of differing words.<br>
+     * Iterating yields every location whose value differs, in index order. The compared states must outlive the diff
+     * and stay unchanged while it is used.
+     */
+    class Diff {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Location;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() noexcept = default;
+
+            [[nodiscard]] Location operator*() const noexcept {
+                return Location::at(m_Word * BitArray::Word::length + std::countr_zero(m_Bits), mp_Diff->m_Size);
+            }
+
+            Iterator& operator++() noexcept {
+                m_Bits &= m_Bits - 1;
+                if (m_Bits == 0) advance(m_Word + 1);
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
+                return m_Range == other.m_Range && m_Word == other.m_Word && m_Bits == other.m_Bits;
+            }
+
+        private:
+            friend class Diff;
+
+            const Diff *mp_Diff = nullptr;
+            size_t m_Range = 0;
+            BitArray::array_size_t m_Word = 0;
+            uint64_t m_Bits = 0;
+
+            Iterator(const Diff *diff, const size_t range) noexcept : mp_Diff(diff), m_Range(range) {
+                if (m_Range < mp_Diff->m_Ranges.size()) advance(mp_Diff->m_Ranges[m_Range].begin);
+            }
+
+            /**
+             * Moves to `word`, or to the start of the next range if `word` is past the current one.
+             */
+            void advance(const BitArray::array_size_t word) noexcept {
+                m_Word = word;
+                if (m_Word >= mp_Diff->m_Ranges[m_Range].end) {
+                    if (++m_Range == mp_Diff->m_Ranges.size()) {
+                        m_Word = 0;
+                        m_Bits = 0;
+                        return;
+                    }
+                    m_Word = mp_Diff->m_Ranges[m_Range].begin;
+                }
+                m_Bits = mp_Diff->mp_Words[m_Word].bits ^ mp_Diff->mp_OtherWords[m_Word].bits;
+            }
+        };
+
+        Diff() noexcept : m_Size(0, 0, 0, 0) { }
+
+        [[nodiscard]] const std::vector<WordRange>& ranges() const noexcept { return m_Ranges; }
+        [[nodiscard]] bool empty() const noexcept { return m_Ranges.empty(); }
+
+        /**
+         * @return Number of differing locations.
+         */
+        [[nodiscard]] state_size_t count() const noexcept {
+            state_size_t count = 0;
+            for (const auto& [begin, end] : m_Ranges) {
+                for (auto word = begin; word < end; ++word) count += std::popcount(mp_Words[word].bits ^ mp_OtherWords[word].bits);
+            }
+            return count;
+        }
+
+        [[nodiscard]] Iterator begin() const noexcept { return Iterator(this, 0); }
+        [[nodiscard]] Iterator end() const noexcept { return Iterator(this, m_Ranges.size()); }
+
+        /**
+         * Recomputes the difference between two bit arrays of the given size; the range buffer is reused.
+         */
+        void compute(const BitArray::BitArray& array, const BitArray::BitArray& other, const Size& size) noexcept {
+            m_Size = size;
+            mp_Words = array.getUnderlyingImplementation();
+            mp_OtherWords = other.getUnderlyingImplementation();
+            m_Ranges.clear();
+            for (auto word = array.findFirstDifferentWord(other); word < array.wordCount();
+                 word = array.findFirstDifferentWord(other, word)) {
+                const auto begin = word;
+                while (word < array.wordCount() && mp_Words[word].bits != mp_OtherWords[word].bits) ++word;
+                m_Ranges.push_back({begin, word});
+            }
+        }
+
+    private:
+        Size m_Size;
+        const BitArray::Word *mp_Words = nullptr;
+        const BitArray::Word *mp_OtherWords = nullptr;
+        std::vector<WordRange> m_Ranges;
+    };
+}
+
+#endif //DIFF_H
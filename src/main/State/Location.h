@@ -24,6 +24,20 @@ namespace State {
         }
 
         [[nodiscard]] constexpr state_size_t index(const Size& size) const noexcept { return size.index(x, y, z, w); }
+
+        /**
+         * Inverse of `index`.
+         */
+        [[nodiscard]] static constexpr Location at(const state_size_t index, const Size& size) noexcept {
+            const auto x = static_cast<axis_size_t>(index / size.strideX % size.width);
+            const auto slot = static_cast<axis_size_t>(index % size.slots);
+            return Location {
+                x,
+                static_cast<axis_size_t>(index / size.strideY % size.height),
+                static_cast<axis_size_t>(index / size.strideZ % size.depth),
+                size.conceptMap == nullptr ? slot : size.conceptMap->conceptAt(x, slot),
+            };
+        }
     };
 
     struct Area : Location {
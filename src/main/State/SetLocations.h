@@ -0,0 +1,180 @@
+#ifndef SETLOCATIONS_H
+#define SETLOCATIONS_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+
+#include "State/Size.h"
+#include "State/Location.h"
+
+#include "Array/BitArray.h"
+
+namespace State {
+    /**
+     * Coordinate that selects the whole axis in a `SetLocations` query.
+     */
+    inline constexpr axis_size_t ANY = std::numeric_limits<axis_size_t>::max();
+
+    /**
+     * Forward range over the set locations of a state whose coordinates match a query; each axis is either fixed or
+     * `ANY`, so one range covers a cell, any line or plane, or the whole state.<br>
+     * Days of an (x, y) row come from the projection (see `State::projection`) and concepts of a cell from the state
+     * itself, one word at a time with `countr_zero`, so a sparse query costs one projection word per row plus one step
+     * per set location. Without a projection, every day of a row is visited.<br>
+     * Locations are yielded in (x, y, z, w) order whatever the layout. The state must stay unchanged while iterating.
+     */
+    class SetLocations {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Location;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() noexcept = default;
+
+            [[nodiscard]] Location operator*() const noexcept {
+                const axis_size_t slot = m_WBase + static_cast<axis_size_t>(std::countr_zero(m_WBits));
+                const ConceptMap *conceptMap = mp_Range->m_Size.conceptMap;
+                return Location {m_X, m_Y, m_Z, conceptMap == nullptr ? slot : conceptMap->conceptAt(m_X, slot)};
+            }
+
+            Iterator& operator++() noexcept {
+                m_WBits &= m_WBits - 1;
+                if (m_WBits == 0) advance();
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
+                if (m_Done || other.m_Done) return m_Done == other.m_Done;
+                return m_X == other.m_X && m_Y == other.m_Y && m_Z == other.m_Z && m_WBase == other.m_WBase
+                    && m_WBits == other.m_WBits;
+            }
+
+        private:
+            friend class SetLocations;
+
+            const SetLocations *mp_Range = nullptr;
+            bool m_Done = true;
+            axis_size_t m_X = 0, m_Y = 0, m_Z = 0;
+            axis_size_t m_ZBase = 0, m_WBase = 0;
+            uint64_t m_ZBits = 0; // Remaining days of the current 64-day chunk of the row.
+            uint64_t m_WBits = 0; // Remaining concepts of the current 64-concept chunk of the cell.
+
+            explicit Iterator(const SetLocations *range) noexcept : mp_Range(range), m_Done(range->isEmpty()) {
+                if (m_Done) return;
+                m_X = range->m_Begin[0];
+                m_Y = range->m_Begin[1];
+                loadDays(range->m_Begin[2]);
+                advance();
+            }
+
+            /**
+             * Moves to the next set location, from the next concept chunk, day, day chunk or row in that order.
+             */
+            void advance() noexcept {
+                const auto& range = *mp_Range;
+                while (m_WBits == 0) {
+                    // `m_Z` is `ANY` until a day of the current day chunk was taken.
+                    if (m_Z != ANY && m_WBase + BitArray::Word::length < range.m_End[3]) {
+                        loadConcepts(m_WBase + BitArray::Word::length);
+                        continue;
+                    }
+                    if (m_ZBits != 0) {
+                        m_Z = m_ZBase + static_cast<axis_size_t>(std::countr_zero(m_ZBits));
+                        m_ZBits &= m_ZBits - 1;
+                        loadConcepts(range.m_Begin[3]);
+                        continue;
+                    }
+                    if (m_ZBase + BitArray::Word::length < range.m_End[2]) {
+                        loadDays(m_ZBase + BitArray::Word::length);
+                        continue;
+                    }
+                    if (++m_Y == range.m_End[1]) {
+                        m_Y = range.m_Begin[1];
+                        if (++m_X == range.m_End[0]) {
+                            m_Done = true;
+                            return;
+                        }
+                    }
+                    loadDays(range.m_Begin[2]);
+                }
+            }
+
+            void loadDays(const axis_size_t zBase) noexcept {
+                const auto& range = *mp_Range;
+                m_ZBase = zBase;
+                m_Z = ANY;
+                const auto n = static_cast<uint8_t>(std::min<axis_size_t>(BitArray::Word::length, range.m_End[2] - zBase));
+                if (range.mp_Projection == nullptr) {
+                    m_ZBits = BitArray::Word::ALL_BITS_SET >> (BitArray::Word::length - n);
+                } else {
+                    const auto projectionIndex = (static_cast<state_size_t>(m_X) * range.m_Size.height + m_Y) * range.m_Size.depth + zBase;
+                    m_ZBits = range.mp_Projection->wordn(projectionIndex, n);
+                }
+            }
+
+            void loadConcepts(const axis_size_t wBase) noexcept {
+                const auto& range = *mp_Range;
+                m_WBase = wBase;
+                if (range.m_FixedConcept != ANY && range.m_Size.conceptMap != nullptr) {
+                    // The slot of a fixed concept depends on X
+                    const axis_size_t slot = range.m_Size.conceptMap->slot(m_X, range.m_FixedConcept);
+                    m_WBase = slot == ConceptMap::NONE ? 0 : slot;
+                    m_WBits = slot == ConceptMap::NONE ? 0 : range.mp_Matrix->get(range.m_Size.offset(m_X, m_Y, m_Z) + slot);
+                    return;
+                }
+                const auto n = static_cast<uint8_t>(std::min<axis_size_t>(BitArray::Word::length, range.m_End[3] - wBase));
+                m_WBits = range.mp_Matrix->wordn(range.m_Size.offset(m_X, m_Y, m_Z) + wBase, n);
+            }
+        };
+
+        /**
+         * @param projection Projection of `matrix`, or `nullptr` if it is not tracked.
+         */
+        SetLocations(const BitArray::BitArray& matrix, const BitArray::BitArray *projection, const Size& size,
+                     const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) noexcept
+            : mp_Matrix(&matrix), mp_Projection(projection), m_Size(size), m_FixedConcept(w) {
+            const axis_size_t coordinates[4] = {x, y, z, w};
+            const axis_size_t extents[4] = {size.width, size.height, size.depth, size.concepts};
+            for (uint8_t axis = 0; axis < 4; ++axis) {
+                assert((coordinates[axis] == ANY || coordinates[axis] < extents[axis]) && "Coordinate out of bounds.");
+                m_Begin[axis] = coordinates[axis] == ANY ? 0 : coordinates[axis];
+                m_End[axis] = coordinates[axis] == ANY ? extents[axis] : coordinates[axis] + 1;
+            }
+            // W is walked in slots; a fixed concept of a compressed state is resolved per X (see `loadConcepts`)
+            if (w == ANY) {
+                m_End[3] = size.slots;
+            } else if (size.conceptMap != nullptr) {
+                m_Begin[3] = 0;
+                m_End[3] = 1;
+            }
+        }
+
+        [[nodiscard]] Iterator begin() const noexcept { return Iterator(this); }
+        [[nodiscard]] Iterator end() const noexcept { return Iterator(); }
+
+    private:
+        const BitArray::BitArray *mp_Matrix;
+        const BitArray::BitArray *mp_Projection;
+        Size m_Size;
+        axis_size_t m_FixedConcept;
+        axis_size_t m_Begin[4] {};
+        axis_size_t m_End[4] {};
+
+        [[nodiscard]] bool isEmpty() const noexcept {
+            return std::ranges::any_of(m_End, [](const axis_size_t end) { return end == 0; });
+        }
+    };
+}
+
+#endif //SETLOCATIONS_H
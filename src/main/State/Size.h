@@ -1,53 +1,133 @@
 #ifndef SIZE_H
 #define SIZE_H
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 
+#include "State/ConceptMap.h"
+
 namespace State {
     typedef uint32_t axis_size_t;
     typedef uint64_t state_size_t;
 
+    /**
+     * Order of the axes in the flat state, outermost first.<br>
+     * W stays innermost in every layout, so the concepts of one (x, y, z) cell remain a contiguous run.
+     */
+    enum class Layout : uint8_t {
+        XYZW = 0,
+        XZYW,
+        YXZW,
+        YZXW,
+        ZXYW,
+        ZYXW,
+    };
+
     struct Size {
         axis_size_t width;
         axis_size_t height;
         axis_size_t depth;
         axis_size_t concepts;
+        Layout layout;
+
+        // Bits stored per (x, y, z) cell: `concepts`, or fewer in a compressed state (see `ConceptMap`).
+        axis_size_t slots;
+        const ConceptMap *conceptMap;
+
+        // Cached distances between neighbouring indices along each axis; W always has a stride of 1.
+        state_size_t strideX;
+        state_size_t strideY;
+        state_size_t strideZ;
+
+        constexpr Size(const axis_size_t width, const axis_size_t height, const axis_size_t depth,
+                       const axis_size_t concepts, const Layout layout = Layout::XYZW,
+                       const ConceptMap *conceptMap = nullptr) noexcept : width(width),
+            height(height),
+            depth(depth),
+            concepts(concepts),
+            layout(layout),
+            slots(conceptMap == nullptr ? concepts : conceptMap->slots()),
+            conceptMap(conceptMap),
+            strideX(0),
+            strideY(0),
+            strideZ(0) {
+            const axis_size_t extents[3] = {width, height, depth};
+            state_size_t strides[3] = {};
+            state_size_t stride = slots;
+            for (const uint8_t axis : innermostFirst(layout)) {
+                strides[axis] = stride;
+                stride *= extents[axis];
+            }
+            strideX = strides[0];
+            strideY = strides[1];
+            strideZ = strides[2];
+        }
+
+        /**
+         * Same extents, layout and concept map (compared by identity), hence the same index of every location.
+         */
+        [[nodiscard]] constexpr bool operator==(const Size& other) const noexcept = default;
 
         [[nodiscard]] bool isValid() const noexcept { return width > 0 && height > 0 && depth > 0 && concepts > 0; }
 
-        [[nodiscard]] state_size_t volume() const noexcept { return width * height * depth * concepts; }
+        [[nodiscard]] state_size_t volume() const noexcept { return width * height * depth * slots; }
+
+        /**
+         * @return Slot of concept `w` in the cells of `x`; `w` itself unless the state is compressed.
+         */
+        [[nodiscard]] constexpr axis_size_t slot(const axis_size_t x, const axis_size_t w) const noexcept {
+            assert(w < concepts && "W must be less than the total concept count.");
+            if (conceptMap == nullptr) [[likely]] return w;
+            assert(conceptMap->isValid(x, w) && "W is not valid for this X in a compressed state.");
+            return conceptMap->slot(x, w);
+        }
 
         [[nodiscard]] constexpr state_size_t offset(const axis_size_t x, const axis_size_t y) const noexcept {
             assert(x < width && "X must be less than the width.");
             assert(y < height && "Y must be less than the height.");
-            return x * height * depth * concepts + y * depth * concepts;
+            return x * strideX + y * strideY;
         }
 
         [[nodiscard]] constexpr state_size_t offset(const axis_size_t x, const axis_size_t y, const axis_size_t z) const noexcept {
             assert(z < depth && "Z must be less than the depth.");
-            return offset(x, y) + z * concepts;
+            return offset(x, y) + z * strideZ;
         }
 
         [[nodiscard]] constexpr state_size_t index(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) const noexcept {
-            assert(w < concepts && "W must be less than the total concept count.");
-            return offset(x, y, z) + w;
+            return offset(x, y, z) + slot(x, w);
         }
 
         [[nodiscard]] constexpr state_size_t offsetX(const axis_size_t y, const axis_size_t z, const axis_size_t w) const noexcept {
-            return y * depth * concepts + z * concepts + w;
+            assert(conceptMap == nullptr && "The slot of W depends on X in a compressed state.");
+            return y * strideY + z * strideZ + w;
         }
 
         [[nodiscard]] constexpr state_size_t offsetY(const axis_size_t x, const axis_size_t z, const axis_size_t w) const noexcept {
-            return x * height * depth * concepts + z * concepts + w;
+            return x * strideX + z * strideZ + slot(x, w);
         }
 
         [[nodiscard]] constexpr state_size_t offsetZ(const axis_size_t x, const axis_size_t y, const axis_size_t w) const noexcept {
-            return x * height * depth * concepts + y * depth * concepts + w;
+            return x * strideX + y * strideY + slot(x, w);
         }
 
         [[nodiscard]] constexpr state_size_t offsetW(const axis_size_t x, const axis_size_t y, const axis_size_t z) const noexcept {
-            return x * height * depth * concepts + y * depth * concepts + z * concepts;
+            return x * strideX + y * strideY + z * strideZ;
+        }
+
+    private:
+        /**
+         * @return Axes X (0), Y (1) and Z (2), innermost first.
+         */
+        [[nodiscard]] static constexpr std::array<uint8_t, 3> innermostFirst(const Layout layout) noexcept {
+            switch (layout) {
+                case Layout::XZYW: return {1, 2, 0};
+                case Layout::YXZW: return {2, 0, 1};
+                case Layout::YZXW: return {0, 2, 1};
+                case Layout::ZXYW: return {1, 0, 2};
+                case Layout::ZYXW: return {0, 1, 2};
+                default: return {2, 1, 0};
+            }
         }
     };
 }
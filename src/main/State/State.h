@@ -1,13 +1,22 @@
 #ifndef STATE_H
 #define STATE_H
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
 #include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
 
 #include "Time/Range.h"
 #include "State/Axes.h"
 #include "State/Size.h"
+#include "State/ConceptMap.h"
 #include "State/Location.h"
+#include "State/Diff.h"
+#include "State/SetLocations.h"
 
 #include "Array/BitArray.h"
 
@@ -16,28 +25,82 @@ namespace State {
     class State {
     public:
         State(const Time::Range& range, const std::chrono::time_zone *timeZone, const Axes::Axis<X>* x, const Axes::Axis<Y>* y,
-                      const Axes::Axis<Z>* z, const Axes::Axis<W>* w) noexcept : m_Size(x->size(), y->size(), z->size(), w->size()),
+                      const Axes::Axis<Z>* z, const Axes::Axis<W>* w, const Layout layout = Layout::XYZW) noexcept :
+                                                                        m_Size(x->size(), y->size(), z->size(), w->size(), layout),
                                                                         m_Range(range),
                                                                         mp_TimeZone(timeZone),
                                                                         m_Matrix(m_Size.volume()),
+                                                                        m_Projection(m_Size.width * m_Size.height * m_Size.depth),
+                                                                        m_Occupancy(m_Size.width * m_Size.depth, 0),
                                                                         m_X(x),
                                                                         m_Y(y),
                                                                         m_Z(z),
                                                                         m_W(w) { }
 
         State(const Time::Range& range, const Axes::Axis<X>* x, const Axes::Axis<Y>* y,
-              const Axes::Axis<Z>* z, const Axes::Axis<W>* w) noexcept : State(range, nullptr, x, y, z, w) {}
+              const Axes::Axis<Z>* z, const Axes::Axis<W>* w, const Layout layout = Layout::XYZW) noexcept :
+            State(range, nullptr, x, y, z, w, layout) {}
+
+        /**
+         * Compressed state: only the concepts `conceptMap` lists as valid for an X are stored (see `ConceptMap`).
+         * The API is that of a dense state; invalid concepts read as unassigned and writes to them are ignored.
+         */
+        State(const Time::Range& range, const std::chrono::time_zone *timeZone, const Axes::Axis<X>* x,
+              const Axes::Axis<Y>* y, const Axes::Axis<Z>* z, const Axes::Axis<W>* w,
+              std::shared_ptr<const ConceptMap> conceptMap, const Layout layout = Layout::XYZW) noexcept :
+            m_Size(x->size(), y->size(), z->size(), w->size(), layout, conceptMap.get()),
+            m_Range(range),
+            mp_TimeZone(timeZone),
+            m_Matrix(m_Size.volume()),
+            m_Projection(m_Size.width * m_Size.height * m_Size.depth),
+            m_Occupancy(m_Size.width * m_Size.depth, 0),
+            mp_ConceptMap(std::move(conceptMap)),
+            m_X(x),
+            m_Y(y),
+            m_Z(z),
+            m_W(w) {
+            assert(mp_ConceptMap->width() == m_Size.width && mp_ConceptMap->concepts() == m_Size.concepts && "Concept map does not match the axes.");
+        }
 
         State(const State &other) noexcept : m_Size(other.m_Size),
                                     m_Range(other.m_Range),
                                     mp_TimeZone(other.mp_TimeZone),
                                     m_Matrix(other.m_Matrix),
+                                    m_TracksProjection(other.m_TracksProjection),
+                                    m_Projection(other.m_Projection),
+                                    m_Occupancy(other.m_Occupancy),
+                                    m_TracksHash(other.m_TracksHash),
+                                    m_Hash(other.m_Hash),
+                                    mp_ConceptMap(other.mp_ConceptMap),
                                     m_X(other.m_X),
                                     m_Y(other.m_Y),
                                     m_Z(other.m_Z),
                                     m_W(other.m_W) { }
 
-        State &operator=(const State &other) noexcept = default;
+        /**
+         * Copies the contents like the copy constructor; the journal isn't copied, so this state ends up outside of any
+         * transaction (see `begin`).
+         */
+        State &operator=(const State &other) noexcept {
+            if (this == &other) return *this;
+            m_Size = other.m_Size;
+            m_Range = other.m_Range;
+            mp_TimeZone = other.mp_TimeZone;
+            m_Matrix = other.m_Matrix;
+            m_TracksProjection = other.m_TracksProjection;
+            m_Projection = other.m_Projection;
+            m_Occupancy = other.m_Occupancy;
+            m_TracksHash = other.m_TracksHash;
+            m_Hash = other.m_Hash;
+            mp_ConceptMap = other.mp_ConceptMap;
+            m_X = other.m_X;
+            m_Y = other.m_Y;
+            m_Z = other.m_Z;
+            m_W = other.m_W;
+            m_JournalActive = false;
+            m_Journal.clear();
+            return *this;
+        }
 
         ~State() noexcept = default;
 
@@ -54,6 +117,7 @@ namespace State {
         [[nodiscard]] const std::chrono::time_zone *timeZone() const noexcept { return mp_TimeZone; }
 
         [[nodiscard]] const Size& size() const noexcept { return m_Size; }
+        [[nodiscard]] Layout layout() const noexcept { return m_Size.layout; }
 
         [[nodiscard]] axis_size_t sizeX() const noexcept { return m_Size.width; }
         [[nodiscard]] axis_size_t sizeY() const noexcept { return m_Size.height; }
@@ -62,6 +126,42 @@ namespace State {
 
         [[nodiscard]] state_size_t flatSize() const noexcept { return m_Matrix.size(); }
 
+        [[nodiscard]] bool isCompressed() const noexcept { return mp_ConceptMap != nullptr; }
+        [[nodiscard]] const ConceptMap *conceptMap() const noexcept { return mp_ConceptMap.get(); }
+
+        /**
+         * @return Whether concept `w` can be assigned to `x`; always `true` unless the state is compressed.
+         */
+        [[nodiscard]] bool hasConcept(const axis_size_t x, const axis_size_t w) const noexcept {
+            return mp_ConceptMap == nullptr || mp_ConceptMap->isValid(x, w);
+        }
+
+        /**
+         * @return Number of set bits.
+         */
+        [[nodiscard]] state_size_t count() const noexcept { return m_Matrix.count(); }
+
+        /**
+         * @return Number of bits that differ from the other (same size) state.
+         */
+        [[nodiscard]] state_size_t countDifferences(const State& other) const noexcept {
+            return m_Matrix.countDifferences(other.m_Matrix);
+        }
+
+        /**
+         * Computes the difference from the other (same size and layout) state into `result`, reusing its buffers.
+         */
+        void diff(const State& other, Diff& result) const noexcept {
+            assert(m_Size.layout == other.m_Size.layout && "Can't diff states with different layouts.");
+            result.compute(m_Matrix, other.m_Matrix, m_Size);
+        }
+
+        [[nodiscard]] Diff diff(const State& other) const noexcept {
+            Diff result;
+            diff(other, result);
+            return result;
+        }
+
         [[nodiscard]] const Axes::Axis<X>& x() const noexcept { return *m_X; }
         [[nodiscard]] const Axes::Axis<Y>& y() const noexcept { return *m_Y; }
         [[nodiscard]] const Axes::Axis<Z>& z() const noexcept { return *m_Z; }
@@ -79,8 +179,9 @@ namespace State {
         }
 
         uint8_t toggle(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) noexcept {
-            const uint8_t newValue = m_Matrix.get(index(x, y, z, w) ^ 1) & 1;
-            m_Matrix.assign(index(x, y, z, w), newValue);
+            if (!hasConcept(x, w)) [[unlikely]] return 0;
+            const uint8_t newValue = m_Matrix.get(index(x, y, z, w)) ^ 1;
+            assign(x, y, z, w, newValue);
             return newValue;
         }
 
@@ -101,23 +202,31 @@ namespace State {
         }
 
         void assign(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w,
-                    const bool value) noexcept { m_Matrix.assign(index(x, y, z, w), static_cast<uint8_t>(value)); }
+                    const bool value) noexcept {
+            if (value) set(x, y, z, w);
+            else clear(x, y, z, w);
+        }
 
         void assign(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w,
-                    const uint8_t value) noexcept { m_Matrix.assign(index(x, y, z, w), value & 1); }
+                    const uint8_t value) noexcept { assign(x, y, z, w, (value & 1) != 0); }
 
         void assign(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w,
-                    const uint32_t value) noexcept { m_Matrix.assign(index(x, y, z, w), value & 1); }
+                    const uint32_t value) noexcept { assign(x, y, z, w, (value & 1) != 0); }
 
         void assign(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w,
-                    const int32_t value) noexcept { m_Matrix.assign(index(x, y, z, w), value & 1); }
+                    const int32_t value) noexcept { assign(x, y, z, w, (value & 1) != 0); }
 
         void set(const Location& location) noexcept {
             set(location.getX(), location.getY(), location.getZ(), location.getW());
         }
 
         void set(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) noexcept {
-            m_Matrix.set(index(x, y, z, w));
+            if (!hasConcept(x, w)) [[unlikely]] return;
+            if (!writeBit(index(x, y, z, w), 1) || !m_TracksProjection) return;
+            const state_size_t cell = projectionIndex(x, y, z);
+            if (m_Projection.get(cell)) return;
+            m_Projection.set(cell);
+            ++m_Occupancy[x * m_Size.depth + z];
         }
 
         void clear(const Location& location) noexcept {
@@ -125,15 +234,158 @@ namespace State {
         }
 
         void clear(const axis_size_t x, const axis_size_t y, const axis_size_t z, const axis_size_t w) noexcept {
-            m_Matrix.clear(index(x, y, z, w));
+            if (!hasConcept(x, w)) [[unlikely]] return;
+            if (!writeBit(index(x, y, z, w), 0) || !m_TracksProjection) return;
+            const state_size_t cell = projectionIndex(x, y, z);
+            if (!m_Projection.get(cell) || m_Matrix.test(offset(x, y, z), m_Size.slots)) return;
+            m_Projection.clear(cell);
+            --m_Occupancy[x * m_Size.depth + z];
+        }
+
+        /**
+         * Toggles the bits of `mask` in word `word` of the flat state (see `getBitArray`) as one write: a single
+         * journal entry, and a projection update per touched cell. `mask` must not cover padding slots of a compressed
+         * state nor bits past the end.
+         */
+        void flipWord(const BitArray::array_size_t word, const uint64_t mask) noexcept {
+            if (mask == 0) return;
+            if (m_JournalActive && (m_Journal.empty() || m_Journal.back().word != word)) {
+                m_Journal.push_back({word, m_Matrix.getUnderlyingImplementation()[word].bits});
+            }
+            const state_size_t base = static_cast<state_size_t>(word) * BitArray::Word::length;
+            if (m_TracksHash) {
+                for (uint64_t remaining = mask; remaining != 0; remaining &= remaining - 1) m_Hash ^= hashKey(base + std::countr_zero(remaining));
+            }
+            m_Matrix.flipWord(word, mask);
+            if (!m_TracksProjection) return;
+            // The bits of a cell are contiguous, so its flips are consecutive
+            state_size_t previousCell = std::numeric_limits<state_size_t>::max();
+            for (uint64_t remaining = mask; remaining != 0; remaining &= remaining - 1) {
+                const state_size_t cell = (base + std::countr_zero(remaining)) / m_Size.slots;
+                if (cell == previousCell) continue;
+                previousCell = cell;
+                updateProjection(cell * m_Size.slots);
+            }
         }
 
         void setAll() noexcept {
+            journalAllWords();
             m_Matrix.setAll();
+            clearPadding();
+            rebuildProjection();
+            rebuildHash();
         }
 
         void clearAll() noexcept {
+            journalAllWords();
             m_Matrix.clearAll();
+            rebuildProjection();
+            rebuildHash();
+        }
+
+        /**
+         * Enables or disables the Zobrist hash (see `hash`). While enabled, it is kept up to date by every mutator.
+         */
+        void trackHash(const bool enabled) noexcept {
+            m_TracksHash = enabled;
+            rebuildHash();
+        }
+
+        [[nodiscard]] bool tracksHash() const noexcept { return m_TracksHash; }
+
+        /**
+         * @return XOR of the keys of all set bits; equal states of the same size and layout have equal hashes.
+         */
+        [[nodiscard]] uint64_t hash() const noexcept {
+            assert(m_TracksHash && "Hash tracking is disabled.");
+            return m_Hash;
+        }
+
+        /**
+         * Zobrist key of a bit, derived from its index by SplitMix64 instead of a stored table.
+         */
+        [[nodiscard]] static constexpr uint64_t hashKey(const state_size_t index) noexcept {
+            uint64_t key = index + 0x9E3779B97F4A7C15ull;
+            key = (key ^ key >> 30) * 0xBF58476D1CE4E5B9ull;
+            key = (key ^ key >> 27) * 0x94D049BB133111EBull;
+            return key ^ key >> 31;
+        }
+
+        /**
+         * Starts a transaction: until `commit` or `rollback`, the original value of every written word is journaled.
+         */
+        void begin() noexcept {
+            assert(!m_JournalActive && "A transaction is already active.");
+            m_Journal.clear();
+            m_JournalActive = true;
+        }
+
+        /**
+         * Keeps the writes of the active transaction.
+         */
+        void commit() noexcept {
+            assert(m_JournalActive && "No active transaction.");
+            m_JournalActive = false;
+            m_Journal.clear();
+        }
+
+        /**
+         * Undoes the writes of the active transaction in O(changed bits); derived data (projection, hash) follows.
+         */
+        void rollback() noexcept {
+            assert(m_JournalActive && "No active transaction.");
+            m_JournalActive = false;
+            for (auto it = m_Journal.rbegin(); it != m_Journal.rend(); ++it) {
+                const auto *words = m_Matrix.getUnderlyingImplementation();
+                for (uint64_t changed = words[it->word].bits ^ it->bits; changed != 0; changed &= changed - 1) {
+                    const state_size_t i = static_cast<state_size_t>(it->word) * BitArray::Word::length + std::countr_zero(changed);
+                    assign(Location::at(i, m_Size), ((it->bits >> std::countr_zero(changed)) & 1) != 0);
+                }
+            }
+            m_Journal.clear();
+        }
+
+        [[nodiscard]] bool inTransaction() const noexcept { return m_JournalActive; }
+
+        /**
+         * Appends every location whose value differs from the start of the active transaction.
+         */
+        void collectChangedLocations(std::vector<Location>& locations) const noexcept {
+            assert(m_JournalActive && "No active transaction.");
+            // A word may be journaled more than once; its first entry holds the original value.
+            m_JournalScratch.assign(m_Journal.begin(), m_Journal.end());
+            std::ranges::stable_sort(m_JournalScratch, {}, &JournalEntry::word);
+            const auto *words = m_Matrix.getUnderlyingImplementation();
+            for (size_t j = 0; j < m_JournalScratch.size(); ++j) {
+                const auto& [word, bits] = m_JournalScratch[j];
+                if (j > 0 && m_JournalScratch[j - 1].word == word) continue;
+                for (uint64_t changed = words[word].bits ^ bits; changed != 0; changed &= changed - 1) {
+                    const state_size_t i = static_cast<state_size_t>(word) * BitArray::Word::length + std::countr_zero(changed);
+                    locations.push_back(Location::at(i, m_Size));
+                }
+            }
+        }
+
+        /**
+         * Enables or disables the projection (see `projection`). While enabled, it is kept up to date by every mutator.
+         */
+        void trackProjection(const bool enabled) noexcept {
+            m_TracksProjection = enabled;
+            rebuildProjection();
+        }
+
+        [[nodiscard]] bool tracksProjection() const noexcept { return m_TracksProjection; }
+
+        /**
+         * Per (x, y, z) (see `projectionIndex`): whether the cell is assigned in any W.
+         */
+        [[nodiscard]] const BitArray::BitArray& projection() const noexcept { return m_Projection; }
+
+        /**
+         * Index into `projection`; Z is innermost, so the days of an (x, y) row are contiguous.
+         */
+        [[nodiscard]] state_size_t projectionIndex(const axis_size_t x, const axis_size_t y, const axis_size_t z) const noexcept {
+            return (static_cast<state_size_t>(x) * m_Size.height + y) * m_Size.depth + z;
         }
 
         [[nodiscard]] uint8_t get(const Location& location) const noexcept {
@@ -141,19 +393,34 @@ namespace State {
         }
 
         [[nodiscard]] uint8_t get(const axis_size_t x, const axis_size_t y, const axis_size_t z,
-                                  const axis_size_t w) const noexcept { return m_Matrix.get(index(x, y, z, w)); }
+                                  const axis_size_t w) const noexcept {
+            if (!hasConcept(x, w)) [[unlikely]] return 0;
+            return m_Matrix.get(index(x, y, z, w));
+        }
 
         [[nodiscard]] uint8_t get(const axis_size_t x, const axis_size_t y, const axis_size_t z) const noexcept {
-            return m_Matrix.test(offset(x, y, z), m_Size.concepts);
+            if (m_TracksProjection) return m_Projection.get(projectionIndex(x, y, z));
+            return m_Matrix.test(offset(x, y, z), m_Size.slots);
         }
 
         [[nodiscard]] uint8_t getXZ(const axis_size_t x, const axis_size_t z) const noexcept {
+            if (m_TracksProjection) return m_Occupancy[x * m_Size.depth + z] != 0;
             for (axis_size_t y = 0; y < m_Size.height; ++y) {
-                if (m_Matrix.test(offset(x, y, z), m_Size.concepts)) return 1;
+                if (m_Matrix.test(offset(x, y, z), m_Size.slots)) return 1;
             }
             return 0;
         }
 
+        /**
+         * @return Number of Y assigned in any W at (`x`, `z`); O(1) while the projection is tracked.
+         */
+        [[nodiscard]] axis_size_t countXZ(const axis_size_t x, const axis_size_t z) const noexcept {
+            if (m_TracksProjection) return m_Occupancy[x * m_Size.depth + z];
+            axis_size_t count = 0;
+            for (axis_size_t y = 0; y < m_Size.height; ++y) count += m_Matrix.test(offset(x, y, z), m_Size.slots);
+            return count;
+        }
+
         [[nodiscard]] char getCharRepresentation(const Location& location) const noexcept {
             return get(location.getX(), location.getY(), location.getZ(), location.getW());
         }
@@ -165,125 +432,254 @@ namespace State {
 
         void getLineXYW(BitArray::BitArray& dst, const axis_size_t x, const axis_size_t y,
                         const axis_size_t w) const noexcept {
-            m_Matrix.copyTo(
-                dst, x * m_Size.height * m_Size.depth * m_Size.concepts + y * m_Size.depth * m_Size.concepts + w,
-                m_Size.concepts, 0);
+            if (isCompressed()) return getByLocation(dst, 1, m_Size.depth, [&](axis_size_t, const axis_size_t z) { return Location {x, y, z, w}; });
+            m_Matrix.copyTo(dst, m_Size.offsetZ(x, y, w), m_Size.strideZ, 0);
         }
 
         void getLineXZW(BitArray::BitArray& dst, const axis_size_t x, const axis_size_t z,
                         const axis_size_t w) const noexcept {
-            m_Matrix.copyTo(dst, x * m_Size.height * m_Size.depth * m_Size.concepts + z * m_Size.concepts + w,
-                            m_Size.depth * m_Size.concepts, 0);
+            if (isCompressed()) return getByLocation(dst, 1, m_Size.height, [&](axis_size_t, const axis_size_t y) { return Location {x, y, z, w}; });
+            m_Matrix.copyTo(dst, m_Size.offsetY(x, z, w), m_Size.strideY, 0);
         }
 
         void getLineYZW(BitArray::BitArray& dst, const axis_size_t y, const axis_size_t z,
                         const axis_size_t w) const noexcept {
-            m_Matrix.copyTo(dst, y * m_Size.depth * m_Size.concepts + z * m_Size.concepts + w,
-                            m_Size.height * m_Size.depth * m_Size.concepts, 0);
+            if (isCompressed()) return getByLocation(dst, 1, m_Size.width, [&](axis_size_t, const axis_size_t x) { return Location {x, y, z, w}; });
+            m_Matrix.copyTo(dst, m_Size.offsetX(y, z, w), m_Size.strideX, 0);
         }
 
         void getLineXYZ(BitArray::BitArray& dst, const axis_size_t x, const axis_size_t y,
                         const axis_size_t z) const noexcept {
-            m_Matrix.copyTo(
-                dst,
-                x * m_Size.height * m_Size.depth * m_Size.concepts + y * m_Size.depth * m_Size.concepts + z * m_Size.
-                concepts, 1, 0);
+            if (isCompressed()) return getByLocation(dst, 1, m_Size.concepts, [&](axis_size_t, const axis_size_t w) { return Location {x, y, z, w}; });
+            m_Matrix.copyTo(dst, offset(x, y, z), 1, 0);
         }
 
         void getPlaneXY(BitArray::BitArray& dst, const axis_size_t z, const axis_size_t w) const noexcept {
-            for (axis_size_t x = 0; x < m_Size.width; ++x) {
-                for (axis_size_t y = 0; y < m_Size.height; ++y) {
-                    const BitArray::array_size_t srcIndex = index(x, y, z, w);
-                    const BitArray::array_size_t dstIndex = x * m_Size.height + y;
-                    dst.assign(dstIndex, m_Matrix.get(srcIndex));
-                }
-            }
+            if (isCompressed()) return getByLocation(dst, m_Size.width, m_Size.height, [&](const axis_size_t x, const axis_size_t y) { return Location {x, y, z, w}; });
+            getPlane(dst, index(0, 0, z, w), m_Size.strideX, m_Size.width, m_Size.strideY, m_Size.height);
         }
 
         void getPlaneXZ(BitArray::BitArray& dst, const axis_size_t y, const axis_size_t w) const noexcept {
-            for (axis_size_t x = 0; x < m_Size.width; ++x) {
-                for (axis_size_t z = 0; z < m_Size.depth; ++z) {
-                    const BitArray::array_size_t srcIndex = index(x, y, z, w);
-                    const BitArray::array_size_t dstIndex = x * m_Size.depth + z;
-                    dst.assign(dstIndex, m_Matrix.get(srcIndex));
-                }
-            }
+            if (isCompressed()) return getByLocation(dst, m_Size.width, m_Size.depth, [&](const axis_size_t x, const axis_size_t z) { return Location {x, y, z, w}; });
+            getPlane(dst, index(0, y, 0, w), m_Size.strideX, m_Size.width, m_Size.strideZ, m_Size.depth);
         }
 
         void getPlaneYZ(BitArray::BitArray& dst, const axis_size_t x, const axis_size_t w) const noexcept {
-            for (axis_size_t y = 0; y < m_Size.height; ++y) {
-                for (axis_size_t z = 0; z < m_Size.depth; ++z) {
-                    const BitArray::array_size_t srcIndex = index(x, y, z, w);
-                    const BitArray::array_size_t dstIndex = y * m_Size.depth + z;
-                    dst.assign(dstIndex, m_Matrix.get(srcIndex));
-                }
-            }
+            if (isCompressed()) return getByLocation(dst, m_Size.height, m_Size.depth, [&](const axis_size_t y, const axis_size_t z) { return Location {x, y, z, w}; });
+            getPlane(dst, index(x, 0, 0, w), m_Size.strideY, m_Size.height, m_Size.strideZ, m_Size.depth);
         }
 
         void getPlaneXW(BitArray::BitArray& dst, const axis_size_t y, const axis_size_t z) const noexcept {
-            for (axis_size_t x = 0; x < m_Size.width; ++x) {
-                for (axis_size_t w = 0; w < m_Size.concepts; ++w) {
-                    const BitArray::array_size_t srcIndex = index(x, y, z, w);
-                    const BitArray::array_size_t dstIndex = x * m_Size.concepts + w;
-                    dst.assign(dstIndex, m_Matrix.get(srcIndex));
-                }
-            }
+            if (isCompressed()) return getByLocation(dst, m_Size.width, m_Size.concepts, [&](const axis_size_t x, const axis_size_t w) { return Location {x, y, z, w}; });
+            getPlane(dst, offset(0, y, z), m_Size.strideX, m_Size.width, 1, m_Size.slots);
         }
 
         void getPlaneYW(BitArray::BitArray& dst, const axis_size_t x, const axis_size_t z) const noexcept {
-            for (axis_size_t y = 0; y < m_Size.height; ++y) {
-                for (axis_size_t w = 0; w < m_Size.concepts; ++w) {
-                    const BitArray::array_size_t srcIndex = index(x, y, z, w);
-                    const BitArray::array_size_t dstIndex = y * m_Size.concepts + w;
-                    dst.assign(dstIndex, m_Matrix.get(srcIndex));
-                }
-            }
+            if (isCompressed()) return getByLocation(dst, m_Size.height, m_Size.concepts, [&](const axis_size_t y, const axis_size_t w) { return Location {x, y, z, w}; });
+            getPlane(dst, offset(x, 0, z), m_Size.strideY, m_Size.height, 1, m_Size.slots);
         }
 
         void assignPlaneYW(const BitArray::BitArray& src, const axis_size_t x, const axis_size_t z) noexcept {
-            for (axis_size_t y = 0; y < m_Size.height; ++y) {
-                for (axis_size_t w = 0; w < m_Size.concepts; ++w) {
-                    const BitArray::array_size_t dstIndex = index(x, y, z, w);
-                    const BitArray::array_size_t srcIndex = y * m_Size.concepts + w;
-                    m_Matrix.assign(dstIndex, src.get(srcIndex));
+            if (isCompressed()) {
+                for (axis_size_t y = 0; y < m_Size.height; ++y) {
+                    for (axis_size_t slot = 0; slot < m_Size.slots; ++slot) {
+                        const axis_size_t w = mp_ConceptMap->conceptAt(x, slot);
+                        if (w != ConceptMap::NONE) writeBit(offset(x, y, z) + slot, src.get(y * m_Size.concepts + w));
+                    }
                 }
+                rebuildProjection(x, z);
+                return;
             }
+            forEachRun(offset(x, 0, z), m_Size.strideY, m_Size.height, [&](const state_size_t srcIndex, const state_size_t dstIndex, const uint8_t n) {
+                writeBits(dstIndex, src.wordn(srcIndex, n), n);
+            });
+            rebuildProjection(x, z);
         }
 
         void clearPlaneYW(const axis_size_t x, const axis_size_t z) noexcept {
-            for (axis_size_t y = 0; y < m_Size.height; ++y) {
-                for (axis_size_t w = 0; w < m_Size.concepts; ++w) {
-                    const BitArray::array_size_t dstIndex = index(x, y, z, w);
-                    m_Matrix.clear(dstIndex);
-                }
-            }
+            forEachRun(offset(x, 0, z), m_Size.strideY, m_Size.height, [&](const state_size_t, const state_size_t dstIndex, const uint8_t n) {
+                writeBits(dstIndex, 0, n);
+            });
+            rebuildProjection(x, z);
         }
 
         void getPlaneZW(BitArray::BitArray& dst, const axis_size_t x, const axis_size_t y) const noexcept {
-            for (axis_size_t z = 0; z < m_Size.depth; ++z) {
-                for (axis_size_t w = 0; w < m_Size.concepts; ++w) {
-                    const BitArray::array_size_t srcIndex = index(x, y, z, w);
-                    const BitArray::array_size_t dstIndex = z * m_Size.concepts + w;
-                    dst.assign(dstIndex, m_Matrix.get(srcIndex));
-                }
-            }
+            if (isCompressed()) return getByLocation(dst, m_Size.depth, m_Size.concepts, [&](const axis_size_t z, const axis_size_t w) { return Location {x, y, z, w}; });
+            getPlane(dst, offset(x, y, 0), m_Size.strideZ, m_Size.depth, 1, m_Size.slots);
+        }
+
+        /**
+         * Set locations matching the given coordinates, each either fixed or `ANY` (see `SetLocations`); for example
+         * `setLocations(ANY, y)` walks every assignment of `y` and `setLocations(x, ANY, z)` every `y` assigned to `x`
+         * on `z`.
+         */
+        [[nodiscard]] SetLocations setLocations(const axis_size_t x = ANY, const axis_size_t y = ANY,
+                                                const axis_size_t z = ANY, const axis_size_t w = ANY) const noexcept {
+            return SetLocations(m_Matrix, m_TracksProjection ? &m_Projection : nullptr, m_Size, x, y, z, w);
         }
 
         void collectTestIndicesW(const BitArray::BitArray& other, const axis_size_t x, const axis_size_t y,
                                  const axis_size_t z,
                                  std::vector<BitArray::array_size_t>& result) const noexcept {
+            const size_t first = result.size();
             m_Matrix.collectTestIndices(other, offset(x, y, z), result);
+            if (!isCompressed()) return;
+            for (size_t i = first; i < result.size(); ++i) result[i] = mp_ConceptMap->conceptAt(x, result[i]);
         }
 
-        void random(const float probability) noexcept { m_Matrix.random(probability); }
+        void random(const float probability) noexcept {
+            journalAllWords();
+            m_Matrix.random(probability);
+            clearPadding();
+            rebuildProjection();
+            rebuildHash();
+        }
 
-        void random() noexcept { m_Matrix.random(); }
+        void random() noexcept {
+            journalAllWords();
+            m_Matrix.random();
+            clearPadding();
+            rebuildProjection();
+            rebuildHash();
+        }
 
     protected:
         Size m_Size;
         Time::Range m_Range;
         const std::chrono::time_zone *mp_TimeZone;
         BitArray::BitArray m_Matrix;
+        bool m_TracksProjection = true;
+        BitArray::BitArray m_Projection; // Per (x, y, z), see `projectionIndex`.
+        std::vector<axis_size_t> m_Occupancy; // Per (x, z): number of Y assigned in any W.
+        bool m_TracksHash = false;
+        uint64_t m_Hash = 0;
+        std::shared_ptr<const ConceptMap> mp_ConceptMap; // Shared by copies; `m_Size` points to it.
+
+        struct JournalEntry {
+            BitArray::array_size_t word;
+            uint64_t bits; // Before the transaction's first write to the word.
+        };
+
+        bool m_JournalActive = false;
+        std::vector<JournalEntry> m_Journal;
+        mutable std::vector<JournalEntry> m_JournalScratch;
+
+        void journalAllWords() noexcept {
+            if (!m_JournalActive) return;
+            const auto *words = m_Matrix.getUnderlyingImplementation();
+            for (BitArray::array_size_t word = 0; word < m_Matrix.wordCount(); ++word) m_Journal.push_back({word, words[word].bits});
+        }
+
+        /**
+         * @return `true` if the bit changed.
+         */
+        bool writeBit(const state_size_t index, const uint8_t value) noexcept {
+            if (m_Matrix.get(index) == value) return false;
+            if (m_JournalActive) {
+                const auto word = static_cast<BitArray::array_size_t>(index / BitArray::Word::length);
+                if (m_Journal.empty() || m_Journal.back().word != word) m_Journal.push_back({word, m_Matrix.getUnderlyingImplementation()[word].bits});
+            }
+            if (m_TracksHash) m_Hash ^= hashKey(index);
+            m_Matrix.assign(index, value);
+            return true;
+        }
+
+        /**
+         * Word-level `writeBit`: writes the low `n` bits of `bits` from `index` on.
+         */
+        void writeBits(const state_size_t index, const uint64_t bits, const uint8_t n) noexcept {
+            const uint64_t changed = (m_Matrix.wordn(index, n) ^ bits) & BitArray::Word::ALL_BITS_SET >> (BitArray::Word::length - n);
+            if (changed == 0) return;
+            if (m_JournalActive) {
+                const auto first = static_cast<BitArray::array_size_t>(index / BitArray::Word::length);
+                const auto last = static_cast<BitArray::array_size_t>((index + n - 1) / BitArray::Word::length);
+                for (auto word = first; word <= last; ++word) {
+                    if (m_Journal.empty() || m_Journal.back().word != word) m_Journal.push_back({word, m_Matrix.getUnderlyingImplementation()[word].bits});
+                }
+            }
+            if (m_TracksHash) {
+                for (uint64_t remaining = changed; remaining != 0; remaining &= remaining - 1) m_Hash ^= hashKey(index + std::countr_zero(remaining));
+            }
+            m_Matrix.assignWordn(index, bits, n);
+        }
+
+        /**
+         * Calls `f(planeIndex, stateIndex, n)` for every chunk of at most 64 bits of the plane spanned by an outer
+         * axis (`outerStride`, `outerSize`) and W through `base`. Rows that are adjacent in the state are merged into
+         * one run.
+         */
+        template<typename F>
+        void forEachRun(const state_size_t base, const state_size_t outerStride, const axis_size_t outerSize, F&& f) const noexcept {
+            const bool contiguous = outerStride == m_Size.slots;
+            const state_size_t runLength = contiguous ? static_cast<state_size_t>(outerSize) * m_Size.slots : m_Size.slots;
+            const axis_size_t runCount = contiguous ? 1 : outerSize;
+            for (axis_size_t run = 0; run < runCount; ++run) {
+                const state_size_t stateIndex = base + run * outerStride;
+                const state_size_t planeIndex = static_cast<state_size_t>(run) * runLength;
+                for (state_size_t i = 0; i < runLength; i += BitArray::Word::length) {
+                    const auto n = static_cast<uint8_t>(std::min<state_size_t>(BitArray::Word::length, runLength - i));
+                    f(planeIndex + i, stateIndex + i, n);
+                }
+            }
+        }
+
+        /**
+         * Clears the slots of a compressed state that hold no concept, after a bulk write that ignores the concept map.
+         */
+        void clearPadding() noexcept {
+            if (!isCompressed()) return;
+            for (axis_size_t x = 0; x < m_Size.width; ++x) {
+                for (axis_size_t slot = 0; slot < m_Size.slots; ++slot) {
+                    if (mp_ConceptMap->conceptAt(x, slot) != ConceptMap::NONE) continue;
+                    for (axis_size_t y = 0; y < m_Size.height; ++y) {
+                        for (axis_size_t z = 0; z < m_Size.depth; ++z) m_Matrix.clear(offset(x, y, z) + slot);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Cell by cell variant of the line and plane getters for a compressed state, where the slot of a concept
+         * depends on X: copies the value at `location(a, b)` into `dst` at `a * sizeB + b`.
+         */
+        template<typename F>
+        void getByLocation(BitArray::BitArray& dst, const axis_size_t sizeA, const axis_size_t sizeB, F&& location) const noexcept {
+            for (axis_size_t a = 0; a < sizeA; ++a) {
+                for (axis_size_t b = 0; b < sizeB; ++b) dst.assign(a * sizeB + b, get(location(a, b)));
+            }
+        }
+
+        /**
+         * Copies the plane spanned by an outer and an inner axis through `base` into `dst`, at
+         * `outer * innerSize + inner`. W rows are copied as runs of words; other rows are gathered into one word per
+         * 64 cells.
+         */
+        void getPlane(BitArray::BitArray& dst, const state_size_t base, const state_size_t outerStride,
+                      const axis_size_t outerSize, const state_size_t innerStride, const axis_size_t innerSize) const noexcept {
+            if (innerStride == 1) {
+                forEachRun(base, outerStride, outerSize, [&](const state_size_t dstIndex, const state_size_t srcIndex, const uint8_t n) {
+                    dst.assignWordn(dstIndex, m_Matrix.wordn(srcIndex, n), n);
+                });
+                return;
+            }
+            state_size_t dstIndex = 0;
+            for (axis_size_t outer = 0; outer < outerSize; ++outer) {
+                state_size_t srcIndex = base + outer * outerStride;
+                for (axis_size_t inner = 0; inner < innerSize; inner += BitArray::Word::length) {
+                    const auto n = static_cast<uint8_t>(std::min<axis_size_t>(BitArray::Word::length, innerSize - inner));
+                    uint64_t bits = 0;
+                    for (uint8_t i = 0; i < n; ++i, srcIndex += innerStride) bits |= static_cast<uint64_t>(m_Matrix.get(srcIndex)) << i;
+                    dst.assignWordn(dstIndex, bits, n);
+                    dstIndex += n;
+                }
+            }
+        }
+
+        void rebuildHash() noexcept {
+            m_Hash = 0;
+            if (!m_TracksHash) return;
+            for (auto i = m_Matrix.findFirstSet(); i < m_Matrix.size(); i = m_Matrix.findFirstSet(i + 1)) m_Hash ^= hashKey(i);
+        }
 
         [[nodiscard]] constexpr state_size_t offset(const axis_size_t x, const axis_size_t y) const noexcept {
             return m_Size.offset(x, y);
@@ -299,6 +695,37 @@ namespace State {
             return m_Size.index(x, y, z, w);
         }
 
+        /**
+         * Brings the projection and occupancy of the cell whose concepts start at `cellOffset` up to date.
+         */
+        void updateProjection(const state_size_t cellOffset) noexcept {
+            const Location location = Location::at(cellOffset, m_Size);
+            const state_size_t cell = projectionIndex(location.x, location.y, location.z);
+            const bool assigned = m_Matrix.test(cellOffset, m_Size.slots);
+            if (static_cast<bool>(m_Projection.get(cell)) == assigned) return;
+            m_Projection.assign(cell, static_cast<uint8_t>(assigned));
+            if (assigned) ++m_Occupancy[location.x * m_Size.depth + location.z];
+            else --m_Occupancy[location.x * m_Size.depth + location.z];
+        }
+
+        void rebuildProjection(const axis_size_t x, const axis_size_t z) noexcept {
+            if (!m_TracksProjection) return;
+            axis_size_t occupancy = 0;
+            for (axis_size_t y = 0; y < m_Size.height; ++y) {
+                const bool assigned = m_Matrix.test(offset(x, y, z), m_Size.slots);
+                m_Projection.assign(projectionIndex(x, y, z), static_cast<uint8_t>(assigned));
+                occupancy += assigned;
+            }
+            m_Occupancy[x * m_Size.depth + z] = occupancy;
+        }
+
+        void rebuildProjection() noexcept {
+            if (!m_TracksProjection) return;
+            for (axis_size_t x = 0; x < m_Size.width; ++x) {
+                for (axis_size_t z = 0; z < m_Size.depth; ++z) rebuildProjection(x, z);
+            }
+        }
+
     private:
         const Axes::Axis<X> *m_X;
         const Axes::Axis<Y> *m_Y;
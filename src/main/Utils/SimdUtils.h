@@ -1,12 +1,15 @@
 #ifndef SIMD_UTILS_H
 #define SIMD_UTILS_H
 
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
 #if defined(__AVX__) && (not defined(_MSC_VER) || (defined(_MSC_VER) && defined(_M_X64)))
 
 #define HAS_SIMD
 
 #include <immintrin.h> // AVX intrinsics
-#include <cstdint>
 
 namespace Simd {
     inline void copy_bits(uint8_t *dst, const uint8_t *src, const size_t count) noexcept {
@@ -27,4 +30,471 @@ namespace Simd {
 
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && not defined(__clang__)
+#include <intrin.h>
+#define SIMD_TARGET(features)
+#else
+#define SIMD_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+/**
+ * Bulk kernels over arrays of 64-bit words.<br>
+ * Each kernel has a scalar implementation and, on x86-64, AVX2 and AVX-512 implementations compiled for their own
+ * target regardless of the build flags. The unqualified `Simd::` functions dispatch to the widest implementation the
+ * host supports, detected once via cpuid.
+ */
+namespace Simd {
+    enum class BitOperation : uint8_t {
+        AND = 0,
+        OR,
+        XOR,
+        AND_NOT, // dst & ~src
+    };
+
+    enum class InstructionSet : uint8_t {
+        SCALAR = 0,
+        AVX2,
+        AVX512,
+    };
+
+    namespace Scalar {
+        template<BitOperation Operation>
+        constexpr uint64_t apply(const uint64_t dst, const uint64_t src) noexcept {
+            if constexpr (Operation == BitOperation::AND) return dst & src;
+            else if constexpr (Operation == BitOperation::OR) return dst | src;
+            else if constexpr (Operation == BitOperation::XOR) return dst ^ src;
+            else return dst & ~src;
+        }
+
+        /**
+         * `dst[i] = dst[i] op src[i]` for `i < n`.
+         */
+        template<BitOperation Operation>
+        void applyWords(uint64_t *dst, const uint64_t *src, const size_t n) noexcept {
+            for (size_t i = 0; i < n; ++i) dst[i] = apply<Operation>(dst[i], src[i]);
+        }
+
+        inline size_t countBits(const uint64_t *words, const size_t n) noexcept {
+            size_t count = 0;
+            for (size_t i = 0; i < n; ++i) count += std::popcount(words[i]);
+            return count;
+        }
+
+        /**
+         * Number of positions set in both `a` and `b`.
+         */
+        inline size_t countCommonBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            size_t count = 0;
+            for (size_t i = 0; i < n; ++i) count += std::popcount(a[i] & b[i]);
+            return count;
+        }
+
+        /**
+         * Number of positions where `a` and `b` differ.
+         */
+        inline size_t countDifferentBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            size_t count = 0;
+            for (size_t i = 0; i < n; ++i) count += std::popcount(a[i] ^ b[i]);
+            return count;
+        }
+
+        /**
+         * @return Index of the first nonzero word, or `n` if all words are zero.
+         */
+        inline size_t findFirstNonZero(const uint64_t *words, const size_t n) noexcept {
+            for (size_t i = 0; i < n; ++i) if (words[i] != 0) return i;
+            return n;
+        }
+
+        /**
+         * @return Index of the first word where `a` and `b` differ, or `n` if they are equal.
+         */
+        inline size_t findFirstDifferent(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            for (size_t i = 0; i < n; ++i) if (a[i] != b[i]) return i;
+            return n;
+        }
+
+        /**
+         * Gathers the bits at `start + i * stride` for `i < n` (`n <= 64`) into the low `n` bits of the result.
+         */
+        inline uint64_t gatherBits(const uint64_t *words, const uint64_t start, const uint64_t stride, const size_t n) noexcept {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const uint64_t position = start + i * stride;
+                bits |= (words[position >> 6] >> (position & 63) & 1) << i;
+            }
+            return bits;
+        }
+    }
+
+    #ifdef SIMD_X86
+    namespace Avx2 {
+        static constexpr size_t WORDS = 4;
+
+        template<BitOperation Operation>
+        SIMD_TARGET("avx2") __m256i apply(const __m256i dst, const __m256i src) noexcept {
+            if constexpr (Operation == BitOperation::AND) return _mm256_and_si256(dst, src);
+            else if constexpr (Operation == BitOperation::OR) return _mm256_or_si256(dst, src);
+            else if constexpr (Operation == BitOperation::XOR) return _mm256_xor_si256(dst, src);
+            else return _mm256_andnot_si256(src, dst);
+        }
+
+        template<BitOperation Operation>
+        SIMD_TARGET("avx2") void applyWords(uint64_t *dst, const uint64_t *src, const size_t n) noexcept {
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), apply<Operation>(a, b));
+            }
+            Scalar::applyWords<Operation>(dst + i, src + i, n - i);
+        }
+
+        /**
+         * Per-byte popcount via nibble lookup, summed into 64-bit lanes.
+         */
+        SIMD_TARGET("avx2") inline __m256i countBits(const __m256i v) noexcept {
+            const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i lowMask = _mm256_set1_epi8(0x0f);
+            const __m256i low = _mm256_and_si256(v, lowMask);
+            const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+            const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+            return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+        }
+
+        SIMD_TARGET("avx2") inline size_t sum(const __m256i v) noexcept {
+            return static_cast<size_t>(_mm256_extract_epi64(v, 0)) + static_cast<size_t>(_mm256_extract_epi64(v, 1))
+                + static_cast<size_t>(_mm256_extract_epi64(v, 2)) + static_cast<size_t>(_mm256_extract_epi64(v, 3));
+        }
+
+        SIMD_TARGET("avx2") inline size_t countBits(const uint64_t *words, const size_t n) noexcept {
+            __m256i total = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                total = _mm256_add_epi64(total, countBits(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i))));
+            }
+            return sum(total) + Scalar::countBits(words + i, n - i);
+        }
+
+        SIMD_TARGET("avx2") inline size_t countCommonBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            __m256i total = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m256i x = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+                                                   _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+                total = _mm256_add_epi64(total, countBits(x));
+            }
+            return sum(total) + Scalar::countCommonBits(a + i, b + i, n - i);
+        }
+
+        SIMD_TARGET("avx2") inline size_t countDifferentBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            __m256i total = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+                                                   _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+                total = _mm256_add_epi64(total, countBits(x));
+            }
+            return sum(total) + Scalar::countDifferentBits(a + i, b + i, n - i);
+        }
+
+        SIMD_TARGET("avx2") inline size_t findFirstNonZero(const uint64_t *words, const size_t n) noexcept {
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+                if (!_mm256_testz_si256(v, v)) break;
+            }
+            return i + Scalar::findFirstNonZero(words + i, n - i);
+        }
+
+        SIMD_TARGET("avx2") inline size_t findFirstDifferent(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+                                                   _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+                if (!_mm256_testz_si256(x, x)) break;
+            }
+            return i + Scalar::findFirstDifferent(a + i, b + i, n - i);
+        }
+
+        /**
+         * Gathers the words of four positions at once and moves each bit to the sign of its lane.
+         */
+        SIMD_TARGET("avx2") inline uint64_t gatherBits(const uint64_t *words, const uint64_t start, const uint64_t stride, const size_t n) noexcept {
+            const __m256i step = _mm256_set1_epi64x(static_cast<long long>(WORDS * stride));
+            const __m256i low = _mm256_set1_epi64x(63);
+            __m256i positions = _mm256_setr_epi64x(static_cast<long long>(start), static_cast<long long>(start + stride),
+                                                   static_cast<long long>(start + 2 * stride), static_cast<long long>(start + 3 * stride));
+            uint64_t bits = 0;
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m256i gathered = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(words), _mm256_srli_epi64(positions, 6), 8);
+                const __m256i signs = _mm256_sllv_epi64(gathered, _mm256_sub_epi64(low, _mm256_and_si256(positions, low)));
+                bits |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(signs))) << i;
+                positions = _mm256_add_epi64(positions, step);
+            }
+            if (i == n) return bits;
+            return bits | Scalar::gatherBits(words, start + i * stride, stride, n - i) << i;
+        }
+    }
+
+    namespace Avx512 {
+        static constexpr size_t WORDS = 8;
+
+        template<BitOperation Operation>
+        SIMD_TARGET("avx512f") __m512i apply(const __m512i dst, const __m512i src) noexcept {
+            if constexpr (Operation == BitOperation::AND) return _mm512_and_si512(dst, src);
+            else if constexpr (Operation == BitOperation::OR) return _mm512_or_si512(dst, src);
+            else if constexpr (Operation == BitOperation::XOR) return _mm512_xor_si512(dst, src);
+            else return _mm512_andnot_si512(src, dst);
+        }
+
+        template<BitOperation Operation>
+        SIMD_TARGET("avx512f") void applyWords(uint64_t *dst, const uint64_t *src, const size_t n) noexcept {
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m512i a = _mm512_loadu_si512(dst + i);
+                const __m512i b = _mm512_loadu_si512(src + i);
+                _mm512_storeu_si512(dst + i, apply<Operation>(a, b));
+            }
+            Scalar::applyWords<Operation>(dst + i, src + i, n - i);
+        }
+
+        SIMD_TARGET("avx512f,avx512vpopcntdq") inline size_t countBits(const uint64_t *words, const size_t n) noexcept {
+            __m512i total = _mm512_setzero_si512();
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+            return static_cast<size_t>(_mm512_reduce_add_epi64(total)) + Scalar::countBits(words + i, n - i);
+        }
+
+        SIMD_TARGET("avx512f,avx512vpopcntdq") inline size_t countCommonBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            __m512i total = _mm512_setzero_si512();
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m512i x = _mm512_and_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                total = _mm512_add_epi64(total, _mm512_popcnt_epi64(x));
+            }
+            return static_cast<size_t>(_mm512_reduce_add_epi64(total)) + Scalar::countCommonBits(a + i, b + i, n - i);
+        }
+
+        SIMD_TARGET("avx512f,avx512vpopcntdq") inline size_t countDifferentBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            __m512i total = _mm512_setzero_si512();
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m512i x = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                total = _mm512_add_epi64(total, _mm512_popcnt_epi64(x));
+            }
+            return static_cast<size_t>(_mm512_reduce_add_epi64(total)) + Scalar::countDifferentBits(a + i, b + i, n - i);
+        }
+
+        SIMD_TARGET("avx512f") inline size_t findFirstNonZero(const uint64_t *words, const size_t n) noexcept {
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m512i v = _mm512_loadu_si512(words + i);
+                if (_mm512_test_epi64_mask(v, v) != 0) break;
+            }
+            return i + Scalar::findFirstNonZero(words + i, n - i);
+        }
+
+        SIMD_TARGET("avx512f") inline size_t findFirstDifferent(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __mmask8 different = _mm512_cmpneq_epi64_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                if (different != 0) return i + std::countr_zero(static_cast<uint32_t>(different));
+            }
+            return i + Scalar::findFirstDifferent(a + i, b + i, n - i);
+        }
+
+        SIMD_TARGET("avx512f") inline uint64_t gatherBits(const uint64_t *words, const uint64_t start, const uint64_t stride, const size_t n) noexcept {
+            const __m512i step = _mm512_set1_epi64(static_cast<long long>(WORDS * stride));
+            const __m512i low = _mm512_set1_epi64(63);
+            const __m512i sign = _mm512_set1_epi64(static_cast<long long>(1ull << 63));
+            alignas(64) uint64_t initial[WORDS];
+            for (size_t k = 0; k < WORDS; ++k) initial[k] = start + k * stride;
+            __m512i positions = _mm512_load_si512(initial);
+            uint64_t bits = 0;
+            size_t i = 0;
+            for (; i + WORDS <= n; i += WORDS) {
+                const __m512i gathered = _mm512_i64gather_epi64(_mm512_srli_epi64(positions, 6), words, 8);
+                const __m512i signs = _mm512_sllv_epi64(gathered, _mm512_sub_epi64(low, _mm512_and_si512(positions, low)));
+                bits |= static_cast<uint64_t>(_mm512_test_epi64_mask(signs, sign)) << i;
+                positions = _mm512_add_epi64(positions, step);
+            }
+            if (i == n) return bits;
+            return bits | Scalar::gatherBits(words, start + i * stride, stride, n - i) << i;
+        }
+    }
+    #endif
+
+    struct CpuFeatures {
+        bool avx2;
+        bool avx512f;
+        bool avx512vpopcntdq;
+    };
+
+    inline CpuFeatures detectCpuFeatures() noexcept {
+        CpuFeatures features {};
+        #ifdef SIMD_X86
+        #if defined(_MSC_VER) && not defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool osSavesYmm = (info[2] & 1 << 27) != 0 && (_xgetbv(0) & 0x06) == 0x06;
+        const bool osSavesZmm = osSavesYmm && (_xgetbv(0) & 0xE0) == 0xE0;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            features.avx2 = osSavesYmm && (info[1] & 1 << 5) != 0;
+            features.avx512f = osSavesZmm && (info[1] & 1 << 16) != 0;
+            features.avx512vpopcntdq = osSavesZmm && (info[2] & 1 << 14) != 0;
+        }
+        #else
+        __builtin_cpu_init();
+        features.avx2 = __builtin_cpu_supports("avx2");
+        features.avx512f = __builtin_cpu_supports("avx512f");
+        features.avx512vpopcntdq = __builtin_cpu_supports("avx512vpopcntdq");
+        #endif
+        #endif
+        return features;
+    }
+
+    /**
+     * Kernel table for one instruction set.
+     */
+    struct Kernels {
+        using ApplyWords = void (*)(uint64_t *, const uint64_t *, size_t) noexcept;
+        using CountBits = size_t (*)(const uint64_t *, size_t) noexcept;
+        using CountPairBits = size_t (*)(const uint64_t *, const uint64_t *, size_t) noexcept;
+        using FindFirstNonZero = size_t (*)(const uint64_t *, size_t) noexcept;
+        using FindFirstDifferent = size_t (*)(const uint64_t *, const uint64_t *, size_t) noexcept;
+        using GatherBits = uint64_t (*)(const uint64_t *, uint64_t, uint64_t, size_t) noexcept;
+
+        InstructionSet instructionSet;
+        ApplyWords applyWords[4]; // Indexed by `BitOperation`.
+        CountBits countBits;
+        CountPairBits countCommonBits;
+        CountPairBits countDifferentBits;
+        FindFirstNonZero findFirstNonZero;
+        FindFirstDifferent findFirstDifferent;
+        GatherBits gatherBits;
+    };
+
+    /**
+     * @param instructionSet Requested instruction set; the caller must make sure the host supports it.
+     * @param features Host features; AVX-512 popcount is used only if `avx512vpopcntdq` is supported.
+     */
+    inline Kernels selectKernels(const InstructionSet instructionSet, const CpuFeatures& features) noexcept {
+        #ifdef SIMD_X86
+        if (instructionSet == InstructionSet::AVX512) {
+            Kernels kernels {
+                InstructionSet::AVX512,
+                {
+                    Avx512::applyWords<BitOperation::AND>, Avx512::applyWords<BitOperation::OR>,
+                    Avx512::applyWords<BitOperation::XOR>, Avx512::applyWords<BitOperation::AND_NOT>,
+                },
+                Avx2::countBits, Avx2::countCommonBits, Avx2::countDifferentBits, Avx512::findFirstNonZero,
+                Avx512::findFirstDifferent, Avx512::gatherBits,
+            };
+            if (features.avx512vpopcntdq) {
+                kernels.countBits = Avx512::countBits;
+                kernels.countCommonBits = Avx512::countCommonBits;
+                kernels.countDifferentBits = Avx512::countDifferentBits;
+            }
+            return kernels;
+        }
+        if (instructionSet == InstructionSet::AVX2) {
+            return Kernels {
+                InstructionSet::AVX2,
+                {
+                    Avx2::applyWords<BitOperation::AND>, Avx2::applyWords<BitOperation::OR>,
+                    Avx2::applyWords<BitOperation::XOR>, Avx2::applyWords<BitOperation::AND_NOT>,
+                },
+                Avx2::countBits, Avx2::countCommonBits, Avx2::countDifferentBits, Avx2::findFirstNonZero,
+                Avx2::findFirstDifferent, Avx2::gatherBits,
+            };
+        }
+        #endif
+        return Kernels {
+            InstructionSet::SCALAR,
+            {
+                Scalar::applyWords<BitOperation::AND>, Scalar::applyWords<BitOperation::OR>,
+                Scalar::applyWords<BitOperation::XOR>, Scalar::applyWords<BitOperation::AND_NOT>,
+            },
+            Scalar::countBits, Scalar::countCommonBits, Scalar::countDifferentBits, Scalar::findFirstNonZero,
+            Scalar::findFirstDifferent, Scalar::gatherBits,
+        };
+    }
+
+    /**
+     * @return Widest instruction set supported by the host.
+     */
+    inline InstructionSet detectInstructionSet(const CpuFeatures& features) noexcept {
+        if (features.avx512f && features.avx2) return InstructionSet::AVX512;
+        if (features.avx2) return InstructionSet::AVX2;
+        return InstructionSet::SCALAR;
+    }
+
+    /**
+     * Kernels for the host, selected on first use.
+     */
+    inline const Kernels& kernels() noexcept {
+        static const Kernels selected = [] {
+            const auto features = detectCpuFeatures();
+            return selectKernels(detectInstructionSet(features), features);
+        }();
+        return selected;
+    }
+
+    /**
+     * Arrays shorter than this (in words) use the inlined scalar kernels, avoiding the indirect call.
+     */
+    static constexpr size_t DISPATCH_THRESHOLD = 8;
+
+    template<BitOperation Operation>
+    void applyWords(uint64_t *dst, const uint64_t *src, const size_t n) noexcept {
+        if (n < DISPATCH_THRESHOLD) return Scalar::applyWords<Operation>(dst, src, n);
+        kernels().applyWords[static_cast<size_t>(Operation)](dst, src, n);
+    }
+
+    inline size_t countBits(const uint64_t *words, const size_t n) noexcept {
+        if (n < DISPATCH_THRESHOLD) return Scalar::countBits(words, n);
+        return kernels().countBits(words, n);
+    }
+
+    inline size_t countCommonBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+        if (n < DISPATCH_THRESHOLD) return Scalar::countCommonBits(a, b, n);
+        return kernels().countCommonBits(a, b, n);
+    }
+
+    inline size_t countDifferentBits(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+        if (n < DISPATCH_THRESHOLD) return Scalar::countDifferentBits(a, b, n);
+        return kernels().countDifferentBits(a, b, n);
+    }
+
+    inline size_t findFirstNonZero(const uint64_t *words, const size_t n) noexcept {
+        if (n < DISPATCH_THRESHOLD) return Scalar::findFirstNonZero(words, n);
+        return kernels().findFirstNonZero(words, n);
+    }
+
+    inline size_t findFirstDifferent(const uint64_t *a, const uint64_t *b, const size_t n) noexcept {
+        if (n < DISPATCH_THRESHOLD) return Scalar::findFirstDifferent(a, b, n);
+        return kernels().findFirstDifferent(a, b, n);
+    }
+
+    /**
+     * See `Scalar::gatherBits`; fewer than `DISPATCH_THRESHOLD` bits are gathered inline.
+     */
+    inline uint64_t gatherBits(const uint64_t *words, const uint64_t start, const uint64_t stride, const size_t n) noexcept {
+        if (n < DISPATCH_THRESHOLD) return Scalar::gatherBits(words, start, stride, n);
+        return kernels().gatherBits(words, start, stride, n);
+    }
+}
+
 #endif //SIMD_UTILS_H
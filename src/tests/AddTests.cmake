@@ -3,3 +3,7 @@ test(test1)
 test(test2)
 test(test3)
 test(test4)
+test(test5)
+test(test6)
+test(test7)
+test(test8)
@@ -0,0 +1,244 @@
+#include "doctest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Array/BitArray.h"
+
+SCENARIO("bit array word access") {
+    GIVEN("a bit array spanning several words") {
+        BitArray::BitArray array(200);
+
+        THEN("its storage is cache line aligned and initially clear") {
+            CHECK(reinterpret_cast<uintptr_t>(array.getUnderlyingImplementation()) % BitArray::CACHE_LINE_SIZE == 0);
+            CHECK(array.wordCount() == 4);
+            CHECK(array.count() == 0);
+        }
+
+        WHEN("assigning single bits") {
+            array.assign(0, true);
+            array.assign(63, static_cast<uint8_t>(1));
+            array.assign(64, static_cast<int32_t>(3)); // Only the lowest bit is assigned.
+            array.assign(199, static_cast<uint64_t>(1));
+            array.assign(199, static_cast<uint64_t>(0));
+
+            THEN("the bits are set accordingly") {
+                CHECK(array.get(0) == 1);
+                CHECK(array.get(63) == 1);
+                CHECK(array[64] == 1);
+                CHECK(array.get(199) == 0);
+                CHECK(array.count() == 3);
+            }
+        }
+
+        WHEN("writing a word across a word boundary") {
+            array.assignWord(40, 0xFFFF'0000'0000'FFFFULL);
+
+            THEN("it reads back from the same unaligned index") {
+                CHECK(array.word(40) == 0xFFFF'0000'0000'FFFFULL);
+                CHECK(array.wordn(40, 16) == 0xFFFFULL);
+                CHECK(array.get(39) == 0);
+                CHECK(array.get(40) == 1);
+                CHECK(array.get(104 - 1) == 1);
+                CHECK(array.get(104) == 0);
+            }
+
+            THEN("range tests see only the written bits") {
+                CHECK(array.test(40, 16));
+                CHECK_FALSE(array.test(56, 32));
+                CHECK(array.test(56, 48));
+                CHECK_FALSE(array.test(0, 40));
+            }
+
+            THEN("a partial word write keeps the surrounding bits") {
+                array.assignWordn(60, 0b0101, 4);
+                CHECK(array.wordn(56, 12) == 0b0101'0000ULL);
+                CHECK(array.get(64) == 0);
+                CHECK(array.get(103) == 1);
+            }
+        }
+
+        WHEN("copying and moving") {
+            array.set(130);
+            BitArray::BitArray copy(array);
+            BitArray::BitArray moved(std::move(copy));
+
+            THEN("the bits are preserved") {
+                CHECK(moved.size() == 200);
+                CHECK(moved.get(130) == 1);
+                CHECK(moved.count() == 1);
+            }
+        }
+    }
+
+    GIVEN("an adapter over a bit array") {
+        BitArray::BitArray array(70);
+        BitArray::BitArrayAdapter adapter(array);
+        BitArray::BitArrayInterface& bitArrayInterface = adapter;
+
+        WHEN("modifying through the interface") {
+            bitArrayInterface.set(69);
+
+            THEN("the adapted array is modified") {
+                CHECK(bitArrayInterface.size() == 70);
+                CHECK(array.get(69) == 1);
+                CHECK(bitArrayInterface.count() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("bit array bulk operations") {
+    GIVEN("two bit arrays spanning many words") {
+        constexpr BitArray::array_size_t size = 1000;
+        BitArray::BitArray a(size), b(size);
+        for (BitArray::array_size_t i = 0; i < size; i += 3) a.set(i);
+        for (BitArray::array_size_t i = 0; i < size; i += 5) b.set(i);
+
+        THEN("counts match a bit by bit count") {
+            CHECK(a.count() == 334);
+            CHECK(b.count() == 200);
+            CHECK(a.count(1, 9) == 3);
+            CHECK(a.count(100, 700) == 233);
+            CHECK(a.countDifferences(b) == 334 + 200 - 2 * 67);
+        }
+
+        WHEN("combining whole arrays") {
+            BitArray::BitArray andResult(a), orResult(a), xorResult(a), andNotResult(a);
+            andResult &= b;
+            orResult |= b;
+            xorResult ^= b;
+            andNotResult.andNot(b);
+
+            THEN("each bit follows the operation") {
+                bool allMatch = true;
+                for (BitArray::array_size_t i = 0; i < size; ++i) {
+                    allMatch = allMatch
+                        && andResult.get(i) == (a.get(i) & b.get(i))
+                        && orResult.get(i) == (a.get(i) | b.get(i))
+                        && xorResult.get(i) == (a.get(i) ^ b.get(i))
+                        && andNotResult.get(i) == (a.get(i) & !b.get(i));
+                }
+                CHECK(allMatch);
+                CHECK(andResult.count() == 67);
+            }
+        }
+
+        WHEN("combining a range") {
+            BitArray::BitArray result(a);
+            result.apply<Simd::BitOperation::AND>(b, 70, 500);
+
+            THEN("only bits inside the range are affected") {
+                bool allMatch = true;
+                for (BitArray::array_size_t i = 0; i < size; ++i) {
+                    const uint8_t expected = i >= 70 && i < 570 ? a.get(i) & b.get(i) : a.get(i);
+                    allMatch = allMatch && result.get(i) == expected;
+                }
+                CHECK(allMatch);
+            }
+        }
+
+        WHEN("searching for set bits") {
+            BitArray::BitArray sparse(size);
+            sparse.set(700);
+            sparse.set(999);
+
+            THEN("the first set bit at or after the start is found") {
+                CHECK(a.findFirstSet() == 0);
+                CHECK(a.findFirstSet(1) == 3);
+                CHECK(sparse.findFirstSet() == 700);
+                CHECK(sparse.findFirstSet(701) == 999);
+                CHECK(BitArray::BitArray(size).findFirstSet() == size);
+            }
+
+            THEN("set bit ranges yield the set indices within their bounds") {
+                std::vector<BitArray::array_size_t> indices;
+                for (const auto index : sparse.setBits()) indices.push_back(index);
+                CHECK(indices == std::vector<BitArray::array_size_t> {700, 999});
+
+                indices.clear();
+                for (const auto index : a.setBits(62, 70)) indices.push_back(index);
+                bool allMatch = indices.size() == 23;
+                for (size_t i = 0; i < indices.size(); ++i) allMatch = allMatch && indices[i] == 63 + 3 * i;
+                CHECK(allMatch);
+
+                CHECK(sparse.setBits(0, 700).begin() == sparse.setBits(0, 700).end());
+                CHECK(sparse.setBits(5, 0).begin() == sparse.setBits(5, 0).end());
+            }
+        }
+
+        WHEN("copying a contiguous unaligned range") {
+            BitArray::BitArray dst(300);
+            a.copyTo(dst, 17, 1, 5);
+
+            THEN("bits are copied in order") {
+                bool allMatch = dst.get(0) == 0 && dst.get(4) == 0;
+                for (BitArray::array_size_t i = 5; i < 300; ++i) allMatch = allMatch && dst.get(i) == a.get(17 + i - 5);
+                CHECK(allMatch);
+            }
+        }
+
+        WHEN("copying a strided range") {
+            BitArray::BitArray dst(300);
+            dst.set(0);
+            dst.set(299);
+            a.copyTo(dst, 5, 7, 3);
+
+            THEN("every stride-th bit is copied in order and the rest is left intact") {
+                bool allMatch = dst.get(0) == 1 && dst.get(1) == 0 && dst.get(299) == 1;
+                for (BitArray::array_size_t i = 3; i < 3 + 143; ++i) allMatch = allMatch && dst.get(i) == a.get(5 + (i - 3) * 7);
+                CHECK(allMatch);
+                CHECK(dst.count(3 + 143, 300 - 3 - 143 - 1) == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("simd kernel dispatch") {
+    GIVEN("word arrays and the kernels of every instruction set the host supports") {
+        constexpr size_t n = 37;
+        uint64_t a[n], b[n];
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = 0x9E3779B97F4A7C15ull * (i + 1);
+            b[i] = i == 30 ? 0 : 0xC2B2AE3D27D4EB4Full ^ (a[i] >> 7);
+        }
+
+        const auto features = Simd::detectCpuFeatures();
+        const auto widest = Simd::detectInstructionSet(features);
+        const auto reference = Simd::selectKernels(Simd::InstructionSet::SCALAR, features);
+
+        THEN("the selected kernels are the widest supported ones") {
+            CHECK(Simd::kernels().instructionSet == widest);
+        }
+
+        THEN("every supported instruction set agrees with the scalar kernels") {
+            bool allMatch = true;
+            for (auto instructionSet = static_cast<uint8_t>(Simd::InstructionSet::SCALAR);
+                 instructionSet <= static_cast<uint8_t>(widest); ++instructionSet) {
+                const auto kernels = Simd::selectKernels(static_cast<Simd::InstructionSet>(instructionSet), features);
+                allMatch = allMatch && kernels.countBits(a, n) == reference.countBits(a, n);
+                allMatch = allMatch && kernels.countCommonBits(a, b, n) == reference.countCommonBits(a, b, n);
+                allMatch = allMatch && kernels.countDifferentBits(a, b, n) == reference.countDifferentBits(a, b, n);
+                allMatch = allMatch && kernels.findFirstNonZero(b + 30, n - 30) == 1;
+                allMatch = allMatch && kernels.findFirstDifferent(a, a, n) == n;
+                allMatch = allMatch && kernels.findFirstDifferent(b, b + 1, 20) == reference.findFirstDifferent(b, b + 1, 20);
+                for (const uint64_t stride : {1ull, 5ull, 31ull, 37ull}) {
+                    for (const size_t count : {3ull, 8ull, 29ull, 64ull}) {
+                        allMatch = allMatch && kernels.gatherBits(a, 3, stride, count) == reference.gatherBits(a, 3, stride, count);
+                    }
+                }
+
+                for (size_t operation = 0; operation < 4; ++operation) {
+                    uint64_t expected[n], actual[n];
+                    std::copy_n(a, n, expected);
+                    std::copy_n(a, n, actual);
+                    reference.applyWords[operation](expected, b, n);
+                    kernels.applyWords[operation](actual, b, n);
+                    allMatch = allMatch && std::equal(expected, expected + n, actual);
+                }
+            }
+            CHECK(allMatch);
+        }
+    }
+}
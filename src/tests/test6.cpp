@@ -0,0 +1,314 @@
+#include "doctest.h"
+
+#include <memory>
+#include <vector>
+
+#include "State/State.h"
+
+namespace {
+    struct Entity : Axes::AxisEntity {};
+
+    constexpr State::Layout LAYOUTS[] = {State::Layout::XYZW, State::Layout::XZYW, State::Layout::YXZW,
+                                         State::Layout::YZXW, State::Layout::ZXYW, State::Layout::ZYXW};
+}
+
+SCENARIO("state memory layouts") {
+    GIVEN("states of the same size in every layout") {
+        const Entity entities[7] {};
+        const Axes::Axis<Entity> x(entities, 3), y(entities, 5), z(entities, 7), w(entities, 2);
+        const Time::Range range(Time::StringToInstant("2025-02-01T00:00:00Z"), Time::StringToInstant("2025-02-08T00:00:00Z"));
+
+        THEN("every index maps to a distinct location and back") {
+            for (const auto layout : LAYOUTS) {
+                const State::State state(range, &x, &y, &z, &w, layout);
+                CAPTURE(static_cast<int>(layout));
+
+                BitArray::BitArray seen(state.flatSize());
+                bool allMatch = true;
+                for (State::state_size_t i = 0; i < state.flatSize(); ++i) {
+                    const State::Location location = State::Location::at(i, state.size());
+                    const auto defaultIndex = location.index(State::Size(3, 5, 7, 2));
+                    allMatch = allMatch && location.index(state.size()) == i && !seen.get(defaultIndex);
+                    seen.set(defaultIndex);
+                }
+                CHECK(allMatch);
+                CHECK(seen.count() == state.flatSize());
+            }
+        }
+
+        THEN("accessors and line getters see set cells") {
+            for (const auto layout : LAYOUTS) {
+                State::State state(range, &x, &y, &z, &w, layout);
+                CAPTURE(static_cast<int>(layout));
+                state.set(2, 4, 6, 1);
+                state.set(1, 3, 0, 0);
+
+                CHECK(state.get(2, 4, 6, 1) == 1);
+                CHECK(state.get(2, 4, 6) == 1);
+                CHECK(state.get(2, 4, 5) == 0);
+                CHECK(state.getXZ(1, 0) == 1);
+                CHECK(state.count() == 2);
+
+                BitArray::BitArray days(7), employees(5), shifts(3);
+                state.getLineXYW(days, 2, 4, 1);
+                state.getLineXZW(employees, 1, 0, 0);
+                state.getLineYZW(shifts, 4, 6, 1);
+                CHECK(days.count() == 1);
+                CHECK(days.get(6) == 1);
+                CHECK(employees.get(3) == 1);
+                CHECK(shifts.get(2) == 1);
+            }
+        }
+
+        THEN("plane getters and setters agree with cell accessors") {
+            bool allMatch = true;
+            for (const auto layout : LAYOUTS) {
+                State::State state(range, &x, &y, &z, &w, layout);
+                state.random(0.4f);
+
+                BitArray::BitArray xy(15), xz(21), yz(35), xw(6), yw(10), zw(14);
+                state.getPlaneXY(xy, 5, 1);
+                state.getPlaneXZ(xz, 3, 0);
+                state.getPlaneYZ(yz, 2, 1);
+                state.getPlaneXW(xw, 4, 6);
+                state.getPlaneYW(yw, 1, 2);
+                state.getPlaneZW(zw, 0, 3);
+                for (State::axis_size_t i = 0; i < 3; ++i) for (State::axis_size_t j = 0; j < 5; ++j) allMatch = allMatch && xy.get(i * 5 + j) == state.get(i, j, 5, 1);
+                for (State::axis_size_t i = 0; i < 3; ++i) for (State::axis_size_t k = 0; k < 7; ++k) allMatch = allMatch && xz.get(i * 7 + k) == state.get(i, 3, k, 0);
+                for (State::axis_size_t j = 0; j < 5; ++j) for (State::axis_size_t k = 0; k < 7; ++k) allMatch = allMatch && yz.get(j * 7 + k) == state.get(2, j, k, 1);
+                for (State::axis_size_t i = 0; i < 3; ++i) for (State::axis_size_t l = 0; l < 2; ++l) allMatch = allMatch && xw.get(i * 2 + l) == state.get(i, 4, 6, l);
+                for (State::axis_size_t j = 0; j < 5; ++j) for (State::axis_size_t l = 0; l < 2; ++l) allMatch = allMatch && yw.get(j * 2 + l) == state.get(1, j, 2, l);
+                for (State::axis_size_t k = 0; k < 7; ++k) for (State::axis_size_t l = 0; l < 2; ++l) allMatch = allMatch && zw.get(k * 2 + l) == state.get(0, 3, k, l);
+
+                state.trackHash(true);
+                const State::State original(state);
+                BitArray::BitArray plane(10);
+                plane.set(0);
+                plane.set(7);
+                state.begin();
+                state.assignPlaneYW(plane, 1, 2);
+                state.getPlaneYW(yw, 1, 2);
+                allMatch = allMatch && yw.countDifferences(plane) == 0 && state.get(1, 0, 2) == 1 && state.get(1, 1, 2) == 0;
+                state.clearPlaneYW(1, 2);
+                allMatch = allMatch && state.getXZ(1, 2) == 0;
+
+                State::State rebuilt(state);
+                rebuilt.trackHash(true);
+                allMatch = allMatch && rebuilt.hash() == state.hash();
+                state.rollback();
+                allMatch = allMatch && state.countDifferences(original) == 0 && state.hash() == original.hash();
+            }
+            CHECK(allMatch);
+        }
+
+        THEN("the assigned-any-skill projection follows the last remaining skill of a cell") {
+            State::State state(range, &x, &y, &z, &w, State::Layout::YZXW);
+            state.set(0, 1, 2, 0);
+            state.set(0, 1, 2, 1);
+            state.set(0, 3, 2, 1);
+            CHECK(state.countXZ(0, 2) == 2);
+            state.clear(0, 1, 2, 0);
+            CHECK(state.get(0, 1, 2) == 1);
+            CHECK(state.countXZ(0, 2) == 2);
+
+            state.clear(0, 1, 2, 1);
+            CHECK(state.get(0, 1, 2) == 0);
+            CHECK(state.getXZ(0, 2) == 1);
+            CHECK(state.countXZ(0, 2) == 1);
+            state.trackProjection(false);
+            CHECK(state.countXZ(0, 2) == 1);
+            state.trackProjection(true);
+
+            state.toggle(0, 3, 2, 1);
+            CHECK(state.getXZ(0, 2) == 0);
+            CHECK(state.projection().count() == 0);
+        }
+
+        THEN("the incremental hash matches a rebuilt one and returns to its value when writes are undone") {
+            State::State state(range, &x, &y, &z, &w);
+            state.trackHash(true);
+            const auto emptyHash = state.hash();
+            state.set(1, 2, 3, 0);
+            state.set(2, 4, 6, 1);
+            state.set(2, 4, 6, 1);
+            state.toggle(0, 0, 0, 0);
+
+            State::State rebuilt(state);
+            rebuilt.trackHash(true);
+            CHECK(rebuilt.hash() == state.hash());
+            CHECK(state.hash() != emptyHash);
+
+            state.clear(1, 2, 3, 0);
+            state.assign(2, 4, 6, 1, false);
+            state.toggle(0, 0, 0, 0);
+            CHECK(state.hash() == emptyHash);
+        }
+
+        THEN("a rolled back transaction restores the state, its projection and its hash") {
+            State::State state(range, &x, &y, &z, &w, State::Layout::YXZW);
+            state.trackHash(true);
+            state.set(1, 2, 3, 0);
+            state.set(0, 4, 6, 1);
+            const State::State original(state);
+
+            state.begin();
+            state.clear(1, 2, 3, 0);
+            state.set(2, 2, 3, 1);
+            state.set(2, 2, 3, 1);
+            state.toggle(0, 0, 0, 0);
+            state.toggle(0, 0, 0, 0);
+
+            std::vector<State::Location> changed;
+            state.collectChangedLocations(changed);
+            CHECK(changed.size() == 2);
+
+            state.rollback();
+            CHECK(state.countDifferences(original) == 0);
+            CHECK(state.hash() == original.hash());
+            CHECK(state.get(1, 2, 3) == 1);
+            CHECK(state.get(2, 2, 3) == 0);
+
+            state.begin();
+            state.clearAll();
+            state.commit();
+            CHECK(state.count() == 0);
+            CHECK(state.projection().count() == 0);
+        }
+
+        THEN("copies of a state in a transaction are outside of any transaction") {
+            State::State state(range, &x, &y, &z, &w);
+            state.begin();
+            state.set(1, 2, 3, 0);
+
+            State::State assigned(range, &x, &y, &z, &w, State::Layout::ZYXW);
+            assigned = state;
+            const State::State copied(state);
+            CHECK_FALSE(assigned.inTransaction());
+            CHECK_FALSE(copied.inTransaction());
+            CHECK(assigned.countDifferences(state) == 0);
+
+            assigned.begin();
+            assigned.set(0, 0, 0, 1);
+            assigned.rollback();
+            CHECK(assigned.countDifferences(state) == 0);
+            state.rollback();
+            CHECK(assigned.get(1, 2, 3, 0) == 1);
+        }
+
+        THEN("set location queries yield exactly the matching set cells in (x, y, z, w) order") {
+            constexpr auto ANY = State::ANY;
+            const State::axis_size_t queries[][4] = {
+                {ANY, ANY, ANY, ANY}, {ANY, 3, ANY, ANY}, {1, ANY, 4, ANY}, {2, 0, 6, ANY}, {ANY, ANY, ANY, 1}, {0, 4, ANY, 0},
+            };
+            bool allMatch = true;
+            for (const auto layout : LAYOUTS) {
+                for (const bool tracksProjection : {true, false}) {
+                    State::State state(range, &x, &y, &z, &w, layout);
+                    state.trackProjection(tracksProjection);
+                    state.random(0.2f);
+                    for (const auto& [qx, qy, qz, qw] : queries) {
+                        std::vector<State::Location> expected;
+                        for (State::axis_size_t i = 0; i < 3; ++i) for (State::axis_size_t j = 0; j < 5; ++j)
+                            for (State::axis_size_t k = 0; k < 7; ++k) for (State::axis_size_t l = 0; l < 2; ++l) {
+                                const bool matches = (qx == ANY || qx == i) && (qy == ANY || qy == j)
+                                    && (qz == ANY || qz == k) && (qw == ANY || qw == l);
+                                if (matches && state.get(i, j, k, l)) expected.push_back(State::Location {i, j, k, l});
+                            }
+                        const auto locations = state.setLocations(qx, qy, qz, qw);
+                        allMatch = allMatch && std::vector<State::Location>(locations.begin(), locations.end()) == expected;
+                    }
+                }
+            }
+            CHECK(allMatch);
+
+            State::State empty(range, &x, &y, &z, &w);
+            CHECK(empty.setLocations().begin() == empty.setLocations().end());
+        }
+
+        THEN("a diff yields the changed word ranges and locations in index order") {
+            State::State state(range, &x, &y, &z, &w);
+            State::State other(state);
+            other.set(0, 0, 0, 1);
+            other.set(0, 0, 1, 0);
+            other.set(2, 4, 6, 1);
+            state.set(2, 4, 5, 0);
+
+            const auto diff = state.diff(other);
+            CHECK(diff.ranges().size() == 2);
+            CHECK(diff.count() == 4);
+
+            std::vector<State::Location> locations(diff.begin(), diff.end());
+            REQUIRE(locations.size() == 4);
+            CHECK(locations[0] == State::Location {0, 0, 0, 1});
+            CHECK(locations[1] == State::Location {0, 0, 1, 0});
+            CHECK(locations[2] == State::Location {2, 4, 5, 0});
+            CHECK(locations[3] == State::Location {2, 4, 6, 1});
+            CHECK(state.diff(state).empty());
+        }
+    }
+}
+
+SCENARIO("compressed states") {
+    GIVEN("a concept map that admits few concepts per X") {
+        const Entity entities[7] {};
+        const Axes::Axis<Entity> x(entities, 3), y(entities, 5), z(entities, 7), w(entities, 4);
+        const Time::Range range(Time::StringToInstant("2025-02-01T00:00:00Z"), Time::StringToInstant("2025-02-08T00:00:00Z"));
+        const auto conceptMap = std::make_shared<const State::ConceptMap>(std::vector<std::vector<State::axis_size_t>> {{1}, {3, 0}, {}}, 4);
+
+        THEN("only valid concepts are stored and the dense API is preserved") {
+            for (const auto layout : {State::Layout::XYZW, State::Layout::ZYXW}) {
+                State::State state(range, nullptr, &x, &y, &z, &w, conceptMap, layout);
+                CAPTURE(static_cast<int>(layout));
+                CHECK(state.flatSize() == 3 * 5 * 7 * 2);
+                CHECK(state.sizeW() == 4);
+                CHECK(state.hasConcept(1, 3));
+                CHECK_FALSE(state.hasConcept(0, 0));
+
+                state.set(0, 2, 3, 1);
+                state.set(1, 4, 6, 3);
+                state.set(1, 4, 6, 0);
+                state.set(0, 2, 3, 2); // Not stored
+                state.set(2, 0, 0, 0); // Not stored
+                CHECK(state.count() == 3);
+                CHECK(state.get(0, 2, 3, 1) == 1);
+                CHECK(state.get(0, 2, 3, 2) == 0);
+                CHECK(state.get(1, 4, 6) == 1);
+                CHECK(state.toggle(2, 0, 0, 0) == 0);
+
+                const std::vector<State::Location> expected {{0, 2, 3, 1}, {1, 4, 6, 0}, {1, 4, 6, 3}};
+                const auto all = state.setLocations();
+                CHECK(std::vector<State::Location>(all.begin(), all.end()) == expected);
+                const auto fixed = state.setLocations(State::ANY, State::ANY, State::ANY, 3);
+                CHECK(std::vector<State::Location>(fixed.begin(), fixed.end()) == std::vector<State::Location> {{1, 4, 6, 3}});
+
+                bool allMatch = true;
+                for (State::state_size_t i = 0; i < state.flatSize(); ++i) {
+                    if (!state.getBitArray().get(i)) continue;
+                    allMatch = allMatch && State::Location::at(i, state.size()).index(state.size()) == i;
+                }
+                CHECK(allMatch);
+
+                BitArray::BitArray yw(5 * 4), xw(3 * 4);
+                state.getPlaneYW(yw, 1, 6);
+                state.getPlaneXW(xw, 2, 3);
+                CHECK(yw.count() == 2);
+                CHECK(yw.get(4 * 4 + 3) == 1);
+                CHECK(xw.count() == 1);
+                CHECK(xw.get(0 * 4 + 1) == 1);
+
+                State::State filled(state);
+                filled.setAll();
+                CHECK(filled.count() == 5 * 7 * 3);
+
+                state.trackHash(true);
+                const State::State original(state);
+                state.begin();
+                state.clear(1, 4, 6, 0);
+                state.assignPlaneYW(yw, 0, 0);
+                state.rollback();
+                CHECK(state.countDifferences(original) == 0);
+                CHECK(state.hash() == original.hash());
+            }
+        }
+    }
+}
@@ -0,0 +1,236 @@
+#include "doctest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Moves/AssignmentCandidates.h"
+#include "Moves/FlipList.h"
+#include "Moves/HorizontalExchangePerturbator.h"
+#include "Moves/PerturbatorChain.h"
+#include "Moves/PerturbatorPool.h"
+#include "Moves/VerticalExchangePerturbator.h"
+
+namespace {
+    struct Entity : Axes::AxisEntity {};
+
+    using Pool = Moves::PerturbatorPool<Entity, Entity, Entity, Entity>;
+    using Chain = Moves::PerturbatorChain<Entity, Entity, Entity, Entity>;
+    using TestState = State::State<Entity, Entity, Entity, Entity>;
+
+    int g_Clones = 0;
+
+    class SetPerturbator final : public Moves::AutonomousPerturbator<Entity, Entity, Entity, Entity> {
+    public:
+        [[nodiscard]] SetPerturbator *clone() const noexcept override {
+            ++g_Clones;
+            return new SetPerturbator(*this);
+        }
+
+        void configure(const TestState& state) noexcept override { m_Configured = true; }
+        void modify(TestState& state) noexcept override { state.set(m_Location); }
+        void revert(TestState& state) const noexcept override { state.clear(m_Location); }
+        void reset() noexcept override { m_Configured = false; }
+
+        [[nodiscard]] bool isConfigured() const noexcept { return m_Configured; }
+
+    private:
+        State::Location m_Location {0, 1, 0, 1};
+        bool m_Configured = false;
+    };
+}
+
+SCENARIO("perturbator pool") {
+    GIVEN("a pool with one prototype") {
+        const Entity entities[2] {};
+        const Axes::Axis<Entity> axis(entities, 2);
+        const Time::Range range(Time::StringToInstant("2025-02-01T00:00:00Z"), Time::StringToInstant("2025-02-03T00:00:00Z"));
+        TestState state(range, &axis, &axis, &axis, &axis);
+
+        const SetPerturbator prototype;
+        Pool pool;
+        const uint32_t kind = pool.kindOf(&prototype);
+        CHECK(pool.kindOf(&prototype) == kind);
+        g_Clones = 0;
+
+        THEN("released perturbators are reset and reused instead of cloned") {
+            auto *first = pool.acquire(kind);
+            first->configure(state);
+            pool.release({first, kind});
+            auto *second = pool.acquire(kind);
+            CHECK(second == first);
+            CHECK(g_Clones == 1);
+            CHECK_FALSE(static_cast<SetPerturbator *>(second)->isConfigured());
+            pool.release({second, kind});
+        }
+
+        THEN("chains return their perturbators to the pool") {
+            Moves::Perturbator<Entity, Entity, Entity, Entity> *used = nullptr;
+            {
+                Chain chain(pool);
+                auto *perturbator = pool.acquire(kind);
+                perturbator->configure(state);
+                chain.push({perturbator, kind});
+                used = perturbator;
+
+                Chain compound {};
+                chain.modify(state);
+                compound.append(chain);
+                CHECK(chain.empty());
+                CHECK(compound.size() == 1);
+                CHECK(state.count() == 1);
+                compound.revert(state);
+                CHECK(state.count() == 0);
+            }
+            CHECK(pool.acquire(kind) == used);
+            CHECK(g_Clones == 1);
+            pool.release({used, kind});
+        }
+
+        THEN("a full chain evicts its oldest perturbators to the pool") {
+            constexpr size_t extra = 3;
+            std::vector<Moves::Perturbator<Entity, Entity, Entity, Entity> *> pushed;
+            {
+                Chain chain(pool);
+                for (size_t i = 0; i < MAX_PERTURBATOR_HISTORY_SIZE + extra; ++i) pushed.push_back(pool.acquire(kind));
+                for (auto *perturbator : pushed) chain.push({perturbator, kind});
+                CHECK(chain.size() == MAX_PERTURBATOR_HISTORY_SIZE);
+                CHECK(chain.perturbators() == std::vector(pushed.begin() + extra, pushed.end()));
+                // The evicted perturbators are reused first
+                CHECK(g_Clones == MAX_PERTURBATOR_HISTORY_SIZE + extra);
+                auto *reused = pool.acquire(kind);
+                CHECK(std::find(pushed.begin(), pushed.begin() + extra, reused) != pushed.begin() + extra);
+                CHECK(g_Clones == MAX_PERTURBATOR_HISTORY_SIZE + extra);
+                pool.release({reused, kind});
+            }
+        }
+    }
+}
+
+SCENARIO("flip lists") {
+    GIVEN("a state and a flip list for it") {
+        const Entity entities[7] {};
+        const Axes::Axis<Entity> x(entities, 3), y(entities, 5), z(entities, 7), w(entities, 2);
+        const Time::Range range(Time::StringToInstant("2025-02-01T00:00:00Z"), Time::StringToInstant("2025-02-08T00:00:00Z"));
+        TestState state(range, &x, &y, &z, &w, State::Layout::YXZW);
+        state.trackHash(true);
+        state.set(1, 2, 3, 0);
+        const TestState initial = state;
+
+        Moves::FlipList<2> flips;
+        flips.reset(state.size());
+
+        THEN("flips of the same bit cancel out") {
+            CHECK(flips.flip(State::Location {1, 2, 3, 1}));
+            CHECK(flips.flip(State::Location {1, 2, 3, 1}));
+            CHECK(flips.empty());
+        }
+
+        THEN("a full list refuses new words only") {
+            CHECK(flips.flip(State::Location {0, 0, 0, 0}));
+            CHECK(flips.flip(State::Location {2, 4, 6, 1}));
+            CHECK(flips.remaining() == 0);
+            CHECK_FALSE(flips.flip(State::Location {1, 2, 3, 0}));
+            CHECK(flips.flip(State::Location {0, 0, 0, 1}));
+            CHECK(flips.size() == 2);
+        }
+
+        THEN("applying toggles the bits like single writes and applying again reverts") {
+            CHECK(flips.flip(State::Location {1, 2, 3, 0}));
+            CHECK(flips.flip(State::Location {1, 2, 4, 1}));
+            CHECK(flips.flip(State::Location {1, 2, 3, 1}));
+
+            TestState expected = state;
+            expected.clear(1, 2, 3, 0);
+            expected.set(1, 2, 4, 1);
+            expected.set(1, 2, 3, 1);
+
+            state.begin();
+            flips.apply(state);
+            CHECK(state.diff(expected).empty());
+            CHECK(state.hash() == expected.hash());
+            CHECK(state.projection().findFirstDifferentWord(expected.projection()) == state.projection().wordCount());
+            CHECK(state.getXZ(1, 4) == 1);
+
+            std::vector<State::Location> fromList, fromState;
+            flips.collectChangedLocations(fromList);
+            state.collectChangedLocations(fromState);
+            std::ranges::sort(fromList, {}, [&](const State::Location& location) { return location.index(state.size()); });
+            CHECK(fromList == fromState);
+            state.commit();
+
+            flips.apply(state);
+            CHECK(state.diff(initial).empty());
+            CHECK(state.hash() == initial.hash());
+            CHECK(state.projection().findFirstDifferentWord(initial.projection()) == state.projection().wordCount());
+            CHECK(state.getXZ(1, 4) == 0);
+        }
+    }
+}
+
+SCENARIO("exchange perturbators") {
+    GIVEN("a state with more shifts than a flip list holds words for, and one assignment per employee and day") {
+        const Entity entities[40] {};
+        const Axes::Axis<Entity> x(entities, 40), y(entities, 3), z(entities, 4), w(entities, 1);
+        const Time::Range range(Time::StringToInstant("2025-02-01T00:00:00Z"), Time::StringToInstant("2025-02-05T00:00:00Z"));
+        TestState state(range, &x, &y, &z, &w);
+        for (State::axis_size_t iy = 0; iy < 3; ++iy)
+            for (State::axis_size_t iz = 0; iz < 4; ++iz) state.set(iy * 4 + iz, iy, iz, 0);
+        const TestState initial = state;
+
+        THEN("vertical exchanges swap two days of every employee") {
+            Moves::VerticalExchangePerturbator<Entity, Entity, Entity, Entity> perturbator;
+            for (int i = 0; i < 10; ++i) {
+                perturbator.configure(state);
+                REQUIRE_FALSE(perturbator.isIdentity());
+                perturbator.modify(state);
+                CHECK(state.diff(initial).count() == 3 * 4);
+                perturbator.revert(state);
+                CHECK(state.diff(initial).empty());
+            }
+        }
+
+        THEN("horizontal exchanges swap every day of two employees") {
+            Moves::HorizontalExchangePerturbator<Entity, Entity, Entity, Entity> perturbator;
+            for (int i = 0; i < 10; ++i) {
+                perturbator.configure(state);
+                REQUIRE_FALSE(perturbator.isIdentity());
+                perturbator.modify(state);
+                CHECK(state.diff(initial).count() == 4 * 4);
+                perturbator.revert(state);
+                CHECK(state.diff(initial).empty());
+            }
+        }
+    }
+}
+
+SCENARIO("assignment candidates") {
+    GIVEN("candidates of a state with some assignments excluded") {
+        Moves::AssignmentCandidates candidates(State::Size(3, 4, 5, 2));
+        candidates.exclude(1, State::ANY, 2, State::ANY);
+        candidates.exclude(State::ANY, 3, State::ANY, 1);
+        candidates.exclude(0, 0, 0, 0);
+        candidates.build();
+
+        THEN("the lists hold exactly the eligible assignments") {
+            CHECK(candidates.count() == 3 * 4 * 5 * 2 - 4 * 2 - (3 * 5 - 1) - 1);
+            CHECK(candidates.pairs(1, 2).empty());
+            CHECK(candidates.pairs(0, 0).size() == 4 * 2 - 2);
+            CHECK(candidates.cells(3).size() == 3 * 5 - 1);
+            CHECK(candidates.cells(3, 2).size() == 2);
+            CHECK(candidates.cells(0, 0).size() == 3 * 2 - 1);
+            CHECK(candidates.cells(0, 2).size() == 2 * 2);
+            CHECK_FALSE(candidates.isEligible(2, 3, 4, 1));
+            CHECK(candidates.isEligible(2, 3, 4, 0));
+
+            size_t pairCount = 0;
+            for (State::axis_size_t x = 0; x < 3; ++x)
+                for (State::axis_size_t z = 0; z < 5; ++z) pairCount += candidates.pairs(x, z).size();
+            CHECK(pairCount == candidates.count());
+
+            bool allEligible = true;
+            for (size_t i = 0; i < candidates.count(); ++i) allEligible = allEligible && candidates.isEligible(candidates.at(i));
+            CHECK(allEligible);
+            CHECK(candidates.at(candidates.count() - 1) == State::Location {2, 3, 4, 0});
+        }
+    }
+}
@@ -0,0 +1,224 @@
+#include "doctest.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Domain/State/DomainState.h"
+#include "Domain/Constraints/EmployeeGeneralConstraint.h"
+#include "Domain/Constraints/ValidShiftDayConstraint.h"
+#include "Domain/Constraints/NoOverlapConstraint.h"
+#include "Domain/Constraints/RequiredSkillConstraint.h"
+#include "Domain/Constraints/ShiftCoverageConstraint.h"
+#include "Domain/Constraints/EmploymentMaxDurationConstraint.h"
+#include "Domain/Constraints/RestBetweenShiftsConstraint.h"
+#include "Domain/Constraints/EmployeeAvailabilityConstraint.h"
+#include "Domain/Constraints/CumulativeFatigueConstraint.h"
+#include "Search/Evaluation.h"
+#include "Search/Implementation/BestImprovementLocalSearchTask.h"
+
+#include "Time/DailyInterval.h"
+#include "Utils/Random.h"
+
+namespace {
+    using axis_size_t = ::State::axis_size_t;
+
+    using DomainConstraint = ::Constraints::Constraint<Domain::Shift, Domain::Employee, Domain::Day, Domain::Skill>;
+
+    constexpr ::State::Layout LAYOUTS[] = {::State::Layout::XYZW, ::State::Layout::ZYXW, ::State::Layout::YXZW};
+
+    /**
+     * Two shifts that require one skill each, and three employees: one per skill and one with both.
+     */
+    struct Instance {
+        const std::chrono::time_zone *timeZone = std::chrono::get_tzdb().locate_zone("UTC");
+        const Time::Range range {Time::StringToInstant("2025-02-03T00:00:00Z"), Time::StringToInstant("2025-02-10T00:00:00Z")};
+        const std::vector<Domain::Shift> shifts = makeShifts();
+        const std::vector<Domain::Employee> employees = makeEmployees();
+        const std::vector<Domain::Day> days = makeDays(range, timeZone);
+        const std::vector<Domain::Skill> skills {Domain::Skill(0, "0"), Domain::Skill(1, "1")};
+
+        const Axes::Axis<Domain::Shift> x {shifts.data(), 2};
+        const Axes::Axis<Domain::Employee> y {employees.data(), 3};
+        const Axes::Axis<Domain::Day> z {days.data(), 7};
+        const Axes::Axis<Domain::Skill> w {skills.data(), 2};
+
+        [[nodiscard]] static std::vector<Domain::Shift> makeShifts() noexcept {
+            std::vector<Domain::Shift> shifts;
+            shifts.emplace_back(0, Domain::Shift::ALL_WEEKDAYS, Time::DailyInterval("08:00", 480), "D", 1);
+            shifts.emplace_back(1, Domain::Shift::ALL_WEEKDAYS, Time::DailyInterval("20:00", 480), "N", 1);
+            shifts[0].addRequiredAllSkill(0, 1.0f);
+            shifts[1].addRequiredAllSkill(1, 1.0f);
+            return shifts;
+        }
+
+        [[nodiscard]] static std::vector<Domain::Employee> makeEmployees() noexcept {
+            std::vector<Domain::Employee> employees;
+            for (axis_size_t i = 0; i < 3; ++i) employees.emplace_back(i);
+            employees[0].addSkill(0, {1.0f, Domain::Workload::Strategy::STATIC, {0.0f, 0.5f, 0.0f}});
+            employees[1].addSkill(1, {1.0f, Domain::Workload::Strategy::STATIC, {0.0f, 0.5f, 0.0f}});
+            employees[2].addSkill(0, {1.0f, Domain::Workload::Strategy::STATIC, {0.0f, 0.5f, 0.0f}});
+            employees[2].addSkill(1, {1.0f, Domain::Workload::Strategy::STATIC, {0.0f, 0.5f, 0.0f}});
+            return employees;
+        }
+
+        [[nodiscard]] static std::vector<Domain::Day> makeDays(const Time::Range& range, const std::chrono::time_zone *timeZone) noexcept {
+            std::vector<Domain::Day> days;
+            for (axis_size_t i = 0; i < 7; ++i) days.emplace_back(i, range.getDayRangeAt(i, timeZone));
+            return days;
+        }
+
+        [[nodiscard]] Domain::State::DomainState state(const ::State::Layout layout) const noexcept {
+            return Domain::State::DomainState(range, timeZone, &x, &y, &z, &w, layout);
+        }
+
+        /**
+         * State that only stores the skills some employee can cover a shift with; one per shift here.
+         */
+        [[nodiscard]] Domain::State::DomainState compressedState(const ::State::Layout layout) const noexcept {
+            return Domain::State::DomainState(range, timeZone, &x, &y, &z, &w,
+                                              Domain::Constraints::RequiredSkillConstraint::assignableConcepts(x, y, w), layout);
+        }
+    };
+
+    /**
+     * One instance of every domain constraint for `state`.
+     */
+    [[nodiscard]] std::vector<std::unique_ptr<DomainConstraint>> makeConstraints(const Domain::State::DomainState& state) noexcept {
+        std::vector<std::unique_ptr<DomainConstraint>> constraints;
+        constraints.emplace_back(new Domain::Constraints::EmployeeGeneralConstraint(state.range(), state.timeZone(), state.x(), state.z()));
+        constraints.emplace_back(new Domain::Constraints::ValidShiftDayConstraint(state.range(), state.timeZone(), state.x(), state.y().size(), state.z(), state.w().size()));
+        constraints.emplace_back(new Domain::Constraints::NoOverlapConstraint(state.x()));
+        constraints.emplace_back(new Domain::Constraints::RequiredSkillConstraint(state.x(), state.y(), state.w()));
+        constraints.emplace_back(new Domain::Constraints::ShiftCoverageConstraint(state.range(), state.timeZone(), state.x(), state.z()));
+        constraints.emplace_back(new Domain::Constraints::EmploymentMaxDurationConstraint(state.range(), 7, state.timeZone(), state.x(), state.y(), state.z()));
+        constraints.emplace_back(new Domain::Constraints::RestBetweenShiftsConstraint(state.x()));
+        constraints.emplace_back(new Domain::Constraints::EmployeeAvailabilityConstraint(state.range(), state.timeZone(), state.x(), state.y(), state.z()));
+        constraints.emplace_back(new Domain::Constraints::CumulativeFatigueConstraint(state.x()));
+        return constraints;
+    }
+
+    [[nodiscard]] std::vector<DomainConstraint *> pointers(const std::vector<std::unique_ptr<DomainConstraint>>& owned) noexcept {
+        std::vector<DomainConstraint *> constraints;
+        for (const auto& constraint : owned) constraints.push_back(constraint.get());
+        return constraints;
+    }
+
+    /**
+     * Exposes the current score of the task.
+     */
+    class BestImprovementTask final : public Search::Task::BestImprovementLocalSearchTask<Domain::Shift, Domain::Employee, Domain::Day, Domain::Skill> {
+    public:
+        using BestImprovementLocalSearchTask::BestImprovementLocalSearchTask;
+
+        [[nodiscard]] Score::Score currentScore() const noexcept { return m_CurrentScore; }
+    };
+}
+
+SCENARIO("required skill constraint") {
+    GIVEN("one constraint instance and states of the same size in different layouts") {
+        const Instance instance;
+        Domain::Constraints::RequiredSkillConstraint constraint(instance.x, instance.y, instance.w);
+
+        THEN("every state is scored in its own layout") {
+            for (const auto layout : {LAYOUTS[0], LAYOUTS[1], LAYOUTS[2], LAYOUTS[0]}) {
+                CAPTURE(static_cast<int>(layout));
+                auto state = instance.state(layout);
+                state.set(0, 1, 2, 0); // Employee 1 lacks skill 0
+                state.set(1, 1, 3, 1);
+                state.set(0, 0, 4, 0);
+                state.set(1, 2, 6, 1);
+                CHECK(constraint.evaluate(state, ::Constraints::EvaluationMode::SCORE_ONLY).score().strict == -1);
+                const auto score = constraint.evaluate(state, ::Constraints::EvaluationMode::FULL);
+                REQUIRE(score.violations().size() == 1);
+                CHECK(score.violations()[0].getY() == 1);
+                CHECK(score.violations()[0].getZ() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("delta evaluation") {
+    GIVEN("random rosters of the small instance in several layouts, dense and compressed") {
+        const Instance instance;
+        Random::RandomGenerator& random = Random::generator();
+
+        THEN("delta scores match full evaluations per constraint across commits and rollbacks") {
+            for (const auto mode : {::Constraints::EvaluationMode::SCORE_ONLY, ::Constraints::EvaluationMode::FULL}) {
+                for (const bool compressed : {false, true}) {
+                    for (const auto layout : LAYOUTS) {
+                        CAPTURE(static_cast<int>(mode));
+                        CAPTURE(compressed);
+                        CAPTURE(static_cast<int>(layout));
+                        auto state = compressed ? instance.compressedState(layout) : instance.state(layout);
+                        state.random(0.2f);
+                        const auto owned = makeConstraints(state);
+                        const auto constraints = pointers(owned);
+                        Evaluation::Evaluator<Domain::Shift, Domain::Employee, Domain::Day, Domain::Skill> evaluator(constraints, mode);
+                        (void) evaluator.evaluateState(state);
+                        evaluator.commit();
+
+                        bool allMatch = true;
+                        std::vector<::State::Location> changes;
+                        for (int step = 0; step < 200; ++step) {
+                            state.begin();
+                            for (uint32_t i = random.randomInt(1, 4); i > 0; --i) {
+                                state.toggle(random.randomInt(state.sizeX() - 1), random.randomInt(state.sizeY() - 1),
+                                             random.randomInt(state.sizeZ() - 1), random.randomInt(state.sizeW() - 1));
+                            }
+                            changes.clear();
+                            state.collectChangedLocations(changes);
+
+                            const auto score = evaluator.evaluateStateDelta(state, changes);
+                            allMatch = allMatch && score == Evaluation::evaluateState(state, constraints);
+                            for (size_t c = 0; c < constraints.size(); ++c) {
+                                const auto expected = constraints[c]->evaluate(state, ::Constraints::EvaluationMode::FULL);
+                                allMatch = allMatch && evaluator.constraintScores()[c].score() == expected.score();
+                                // Violations of SCORE_ONLY scores are materialized now and then only, as the search does
+                                if (mode == ::Constraints::EvaluationMode::SCORE_ONLY && step % 5 != 0) continue;
+                                allMatch = allMatch && evaluator.constraintScore(c, state).violations().size() == expected.violations().size();
+                            }
+
+                            if (random.randomInt(1) == 0) {
+                                state.commit();
+                                evaluator.commit();
+                            } else {
+                                state.rollback();
+                                evaluator.rollback();
+                            }
+                        }
+                        CHECK(allMatch);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("best-improvement local search") {
+    GIVEN("a random roster of the small instance") {
+        const Instance instance;
+        auto state = instance.state(::State::Layout::XYZW);
+        state.random(0.2f);
+
+        const auto owned = makeConstraints(state);
+        const auto constraints = pointers(owned);
+
+        Statistics::ScoreStatistics scoreStatistics;
+        Heuristics::HeuristicProvider heuristicProvider(&state, constraints);
+        BestImprovementTask task(state, constraints, scoreStatistics);
+
+        THEN("the current score never decreases and the output state matches the output score") {
+            bool neverDecreases = true;
+            Score::Score previous = task.currentScore();
+            for (int i = 0; i < 50; ++i) {
+                task.step(heuristicProvider);
+                neverDecreases = neverDecreases && task.currentScore() >= previous;
+                previous = task.currentScore();
+            }
+            CHECK(neverDecreases);
+            CHECK(task.getOutputScore() >= task.getInitialScore());
+            CHECK(Evaluation::evaluateState(task.getOutputState(), constraints) == task.getOutputScore());
+        }
+    }
+}